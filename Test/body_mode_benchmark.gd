@@ -0,0 +1,110 @@
+extends SceneTree
+## Compares the frame times of representing a document's USD prims as bodies,
+## as instances and directly within the rendering and physics servers so that
+## the modes can be weighed against each other for large scenes.
+##
+## Run it with the engine, e.g.
+## [codeblock]
+## godot --path Test -s res://body_mode_benchmark.gd -- --document=res://large.automerge
+## [/codeblock]
+## Options:
+## [br]- [code]--document=PATH[/code]: the document whose scene is represented.
+## [br]- [code]--frames=N[/code]: frames to sample per mode.
+## [br]- [code]--warmup=N[/code]: frames to skip per mode before sampling.
+
+const MODES := ["nodes", "instancing", "server_direct"]
+
+var _document_path := "res://cube-island.automerge"
+var _frames := 300
+var _warmup := 60
+
+var _document: AutomergeResource
+var _frame := 0
+var _mode := 0
+var _parent: Node3D
+var _physics_times := PackedFloat64Array()
+var _process_times := PackedFloat64Array()
+
+
+func _initialize() -> void:
+	_parse_arguments()
+	_document = ResourceLoader.load(_document_path, "", ResourceLoader.CACHE_MODE_IGNORE)
+	if not _document:
+		push_error("Unable to load \"%s\"." % _document_path)
+		quit(1)
+		return
+	print("Representing the prims of \"%s\" for %d frames per mode" % [_document_path, _frames])
+	_begin_mode()
+
+
+func _process(_delta: float) -> bool:
+	if not _parent:
+		return false
+	_frame += 1
+	if _frame > _warmup:
+		# Performance reports the times of the previous frame in seconds.
+		_process_times.push_back(Performance.get_monitor(Performance.TIME_PROCESS) * 1000.0)
+		_physics_times.push_back(Performance.get_monitor(Performance.TIME_PHYSICS_PROCESS) * 1000.0)
+	if _frame < _warmup + _frames:
+		return false
+	_end_mode()
+	_mode += 1
+	if _mode == MODES.size():
+		quit(0)
+	else:
+		_begin_mode()
+	return false
+
+
+func _begin_mode() -> void:
+	_frame = 0
+	_physics_times.clear()
+	_process_times.clear()
+	_parent = Node3D.new()
+	var mediator := UsdjMediator.new()
+	mediator.body_instancing = MODES[_mode] == "instancing"
+	mediator.body_server_direct = MODES[_mode] == "server_direct"
+	mediator.document_resource = _document
+	mediator.document_path = "/data/scene"
+	_parent.add_child(mediator)
+	root.add_child(_parent)
+	mediator.document_scan = true
+
+
+func _end_mode() -> void:
+	var mediator: UsdjMediator = _parent.get_child(0)
+	var statistics := mediator.get_update_statistics()
+	print("%s:" % MODES[_mode])
+	print("  Nodes: %d, instances: %d, server prims: %d" % [
+		Performance.get_monitor(Performance.OBJECT_NODE_COUNT),
+		statistics.instances, statistics.server_prims])
+	print("  Process per frame (ms): %s" % _summarize(_process_times))
+	print("  Physics per frame (ms): %s" % _summarize(_physics_times))
+	root.remove_child(_parent)
+	_parent.free()
+	_parent = null
+
+
+func _parse_arguments() -> void:
+	for argument in OS.get_cmdline_user_args():
+		var pair := argument.trim_prefix("--").split("=", true, 1)
+		match pair[0]:
+			"document":
+				_document_path = pair[1]
+			"frames":
+				_frames = pair[1].to_int()
+			"warmup":
+				_warmup = pair[1].to_int()
+
+
+func _summarize(samples: PackedFloat64Array) -> String:
+	var sorted := samples.duplicate()
+	sorted.sort()
+	var total := 0.0
+	for sample in sorted:
+		total += sample
+	return "mean %.2f, p50 %.2f, p99 %.2f, max %.2f" % [
+		total / sorted.size(),
+		sorted[sorted.size() / 2],
+		sorted[mini(sorted.size() - 1, int(sorted.size() * 0.99))],
+		sorted[-1]]
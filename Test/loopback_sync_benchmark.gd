@@ -0,0 +1,170 @@
+extends SceneTree
+## Measures how quickly a [UsdjMediator] keeps up with a loopback
+## [AutomergeSyncServer] so that changes to the synchronization path can be
+## compared without a network or a live server.
+##
+## Run it with an editor build of the engine, e.g.
+## [codeblock]
+## godot --headless --path Test -s res://loopback_sync_benchmark.gd -- --history=10000 --rate=100
+## [/codeblock]
+## Options:
+## [br]- [code]--history=N[/code]: changes in the document before the client connects.
+## [br]- [code]--rate=N[/code]: changes per second made while the client is connected.
+## [br]- [code]--duration=S[/code]: seconds to keep making changes for.
+## [br]- [code]--fps=N[/code]: frame rate limit, e.g. that of an XR headset.
+## [br]- [code]--threaded[/code]: synchronize on a worker thread.
+## [br]- [code]--scan[/code]: construct bodies for the document's scene too.
+## [br]- [code]--instancing[/code]: render the scene's prims without collision as instances.
+
+const PORT := 8765
+const STRATE_ID := "loopback-benchmark"
+## A document that isn't cached so that the benchmark never saves it.
+const DOCUMENT_PATH := "res://a-cube.automerge"
+## Seconds to wait for the client to catch up before giving up.
+const TIMEOUT := 60.0
+
+var _duration := 10.0
+var _history := 10000
+var _instancing := false
+var _rate := 100
+var _scan := false
+var _threaded := false
+
+var _changes := 0
+var _frame_times := PackedFloat64Array()
+var _latencies := PackedFloat64Array()
+var _mediator: UsdjMediator
+var _owed := 0.0
+var _server: AutomergeSyncServer
+var _start_usec := 0
+var _steady_start_usec := -1
+var _unsynced_usec := -1
+
+
+func _initialize() -> void:
+	_parse_arguments()
+	_server = AutomergeSyncServer.new()
+	if _server.listen(PORT) != OK:
+		push_error("Unable to listen on port %d." % PORT)
+		quit(1)
+		return
+	_server.generate_changes(STRATE_ID, _history)
+	# Start from scratch rather than from a previous run's synchronization.
+	_remove_sync_state()
+	var document := ResourceLoader.load(DOCUMENT_PATH, "", ResourceLoader.CACHE_MODE_IGNORE)
+	_mediator = UsdjMediator.new()
+	_mediator.server_threaded = _threaded
+	_mediator.document_resource = document
+	_mediator.server_domain_name = "ws://127.0.0.1:%d" % PORT
+	_mediator.server_path = STRATE_ID
+	_mediator.server_sync = true
+	if _scan:
+		_mediator.body_instancing = _instancing
+		_mediator.document_path = "/data/scene"
+		_mediator.document_scan = true
+	root.add_child(_mediator)
+	_start_usec = Time.get_ticks_usec()
+
+
+func _process(delta: float) -> bool:
+	_server.poll()
+	var now := Time.get_ticks_usec()
+	if _steady_start_usec < 0:
+		# Wait for the initial history to be synchronized.
+		if _server.is_synced(STRATE_ID):
+			print("Initial sync of %d changes: %.1f ms" % [_history, (now - _start_usec) / 1000.0])
+			_steady_start_usec = now
+		elif now - _start_usec > TIMEOUT * 1000000:
+			push_error("Timed out waiting for the initial sync.")
+			quit(1)
+		return false
+	_frame_times.push_back(Performance.get_monitor(Performance.TIME_PROCESS) * 1000.0)
+	if now - _steady_start_usec < _duration * 1000000:
+		_owed += _rate * delta
+		var count := int(_owed)
+		if count > 0:
+			_owed -= count
+			_changes += _server.generate_changes(STRATE_ID, count)
+			if _unsynced_usec < 0:
+				_unsynced_usec = now
+	if _unsynced_usec >= 0 and _server.is_synced(STRATE_ID):
+		_latencies.push_back((now - _unsynced_usec) / 1000.0)
+		_unsynced_usec = -1
+	if now - _steady_start_usec >= _duration * 1000000 and _unsynced_usec < 0:
+		_report()
+		quit(0)
+	elif now - _steady_start_usec > (_duration + TIMEOUT) * 1000000:
+		push_error("Timed out waiting for the client to catch up.")
+		quit(1)
+	return false
+
+
+func _finalize() -> void:
+	if _mediator:
+		# Close the session so that it saves its synchronization state now.
+		_mediator.server_sync = false
+		_remove_sync_state()
+	if _server:
+		_server.stop()
+
+
+func _parse_arguments() -> void:
+	for argument in OS.get_cmdline_user_args():
+		var pair := argument.trim_prefix("--").split("=", true, 1)
+		match pair[0]:
+			"duration":
+				_duration = pair[1].to_float()
+			"fps":
+				Engine.max_fps = pair[1].to_int()
+			"history":
+				_history = pair[1].to_int()
+			"instancing":
+				_instancing = true
+			"rate":
+				_rate = pair[1].to_int()
+			"scan":
+				_scan = true
+			"threaded":
+				_threaded = true
+
+
+## Deletes the file that the mediator persists its synchronization state to.
+func _remove_sync_state() -> void:
+	var key := ("ws://127.0.0.1:%d_%s" % [PORT, STRATE_ID]).validate_filename()
+	var path := "%s.%s.amsync" % [DOCUMENT_PATH.get_basename(), key]
+	if FileAccess.file_exists(path):
+		DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
+
+
+func _report() -> void:
+	print("Streamed %d changes over %.1f s at %d changes/s (%s)" % [
+		_changes, _duration, _rate, "threaded" if _threaded else "unthreaded"])
+	print("Sync latency (ms): %s" % _summarize(_latencies))
+	print("Process time per frame (ms): %s" % _summarize(_frame_times))
+	print("Round-trip time (ms): %.1f" % (_mediator.server_round_trip_time * 1000.0))
+	var statistics := _mediator.get_update_statistics()
+	print("Body updates: %d, deferred calls: %d, bodies added/revised/removed: %d/%d/%d" % [
+		statistics.updates, statistics.deferred_calls,
+		statistics.bodies_added, statistics.bodies_revised, statistics.bodies_removed])
+	print("Body pool hits: %d, misses: %d, size: %d" % [
+		statistics.pool_hits, statistics.pool_misses, statistics.pool_size])
+	print("Instanced prims: %d, batches: %d" % [statistics.instances, statistics.instance_batches])
+	var cache_statistics := UsdjResourceCache.get_statistics()
+	print("Resource cache geometry hits: %d, misses: %d, material hits: %d, misses: %d, size: %d" % [
+		cache_statistics.geometry_hits, cache_statistics.geometry_misses,
+		cache_statistics.material_hits, cache_statistics.material_misses, cache_statistics.size])
+
+
+func _summarize(samples: PackedFloat64Array) -> String:
+	if samples.is_empty():
+		return "n/a"
+	var sorted := samples.duplicate()
+	sorted.sort()
+	var total := 0.0
+	for sample in sorted:
+		total += sample
+	return "mean %.2f, p50 %.2f, p99 %.2f, max %.2f" % [
+		total / sorted.size(),
+		sorted[sorted.size() / 2],
+		sorted[mini(sorted.size() - 1, int(sorted.size() * 0.99))],
+		sorted[-1]]
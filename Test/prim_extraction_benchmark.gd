@@ -0,0 +1,96 @@
+extends SceneTree
+## Measures how long it takes to extract the properties of each USD prim in a
+## document's scene into its [UsdjStaticBody3D] so that changes to the
+## extraction path can be compared by running it before and after them.
+##
+## Run it with the engine, e.g.
+## [codeblock]
+## godot --headless --path Test -s res://prim_extraction_benchmark.gd -- --iterations=100
+## [/codeblock]
+## Options:
+## [br]- [code]--document=PATH[/code]: the document whose scene is extracted.
+## [br]- [code]--iterations=N[/code]: extractions of every prim to time.
+
+## Seconds to wait for the scene to be materialized before giving up.
+const TIMEOUT := 60.0
+
+var _document_path := "res://cube-island.automerge"
+var _iterations := 100
+
+var _mediator: UsdjMediator
+var _start_usec := 0
+
+
+func _initialize() -> void:
+	_parse_arguments()
+	var document := ResourceLoader.load(_document_path, "", ResourceLoader.CACHE_MODE_IGNORE)
+	if not document:
+		push_error("Unable to load \"%s\"." % _document_path)
+		quit(1)
+		return
+	_mediator = UsdjMediator.new()
+	_mediator.body_materialization_budget = 0.0
+	_mediator.document_resource = document
+	_mediator.document_path = "/data/scene"
+	_mediator.scene_materialized.connect(_on_scene_materialized)
+	_mediator.document_scan = true
+	root.add_child(_mediator)
+	_start_usec = Time.get_ticks_usec()
+
+
+func _process(_delta: float) -> bool:
+	if Time.get_ticks_usec() - _start_usec > TIMEOUT * 1000000:
+		push_error("Timed out waiting for the scene to be materialized.")
+		quit(1)
+	return false
+
+
+func _on_scene_materialized() -> void:
+	var bodies := _mediator.find_children("*", "UsdjStaticBody3D", true, false)
+	if bodies.is_empty():
+		push_error("No prims were materialized.")
+		quit(1)
+		return
+	var revisions := PackedFloat64Array()
+	var extractions := PackedFloat64Array()
+	for iteration in _iterations:
+		for body in bodies:
+			var start := Time.get_ticks_usec()
+			body.revise()
+			var revised := Time.get_ticks_usec()
+			body.get_constant_linear_velocity()
+			body.get_constant_angular_velocity()
+			var finish := Time.get_ticks_usec()
+			revisions.push_back(revised - start)
+			extractions.push_back(finish - start)
+	print("Extracted %d prims %d times from \"%s\"" % [bodies.size(), _iterations, _document_path])
+	print("Revision per prim (us): %s" % _summarize(revisions))
+	print("Revision and velocities per prim (us): %s" % _summarize(extractions))
+	var cache_statistics := UsdjResourceCache.get_statistics()
+	print("Resource cache geometry hits: %d, misses: %d, material hits: %d, misses: %d, size: %d" % [
+		cache_statistics.geometry_hits, cache_statistics.geometry_misses,
+		cache_statistics.material_hits, cache_statistics.material_misses, cache_statistics.size])
+	quit(0)
+
+
+func _parse_arguments() -> void:
+	for argument in OS.get_cmdline_user_args():
+		var pair := argument.trim_prefix("--").split("=", true, 1)
+		match pair[0]:
+			"document":
+				_document_path = pair[1]
+			"iterations":
+				_iterations = pair[1].to_int()
+
+
+func _summarize(samples: PackedFloat64Array) -> String:
+	var sorted := samples.duplicate()
+	sorted.sort()
+	var total := 0.0
+	for sample in sorted:
+		total += sample
+	return "mean %.2f, p50 %.2f, p99 %.2f, max %.2f" % [
+		total / sorted.size(),
+		sorted[sorted.size() / 2],
+		sorted[mini(sorted.size() - 1, int(sorted.size() * 0.99))],
+		sorted[-1]]
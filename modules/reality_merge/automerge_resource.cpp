@@ -29,9 +29,11 @@
 
 #include <filesystem>
 #include <stdexcept>
+#include <string>
 
 // regional
 #include <core/config/project_settings.h>
+#include <core/error/error_macros.h>
 #include <core/io/file_access.h>
 
 // local
@@ -41,11 +43,24 @@ namespace {
 
 char const* CLASS_NAME = "AutomergeResource";
 char const* FILE_EXT = "automerge";
+
+/// \brief Converts a project-relative path into an absolute one.
+std::filesystem::path globalize_path(String const& p_path) {
+    auto const global_path = ProjectSettings::get_singleton()->globalize_path(p_path);
+    auto const buffer = global_path.to_utf8_buffer();
+    return std::filesystem::path{std::string{reinterpret_cast<std::string::const_pointer>(buffer.ptr()),
+                                             static_cast<std::string::size_type>(buffer.size())}};
+}
+
 }  // namespace
 
 // AutomergeResource
+char const* const AutomergeResource::INCREMENTAL_SAVE_SETTING = "reality_merge/automerge/incremental_save";
+
 void AutomergeResource::_bind_methods() {}
 
+AutomergeResource::AutomergeResource() : m_increments_size{0}, m_snapshot_size{0} {}
+
 AutomergeResource::~AutomergeResource() {}
 
 std::optional<std::reference_wrapper<cavi::usdj_am::utils::Document const>> AutomergeResource::get_document() const {
@@ -54,13 +69,31 @@ std::optional<std::reference_wrapper<cavi::usdj_am::utils::Document const>> Auto
     return std::nullopt;
 }
 
-Error AutomergeResource::load(Vector<std::uint8_t> const& p_data, String& p_err_msg) {
+Error AutomergeResource::load(String const& p_path, Vector<std::uint8_t> const& p_data, String& p_err_msg) {
     using cavi::usdj_am::utils::Document;
 
     auto outcome = Error::OK;
     p_err_msg.clear();
     try {
-        m_document.emplace(Document::load(p_data.ptr(), p_data.size()));
+        std::size_t size = p_data.size();
+        try {
+            m_document.emplace(Document::load(p_data.ptr(), size));
+        } catch (std::invalid_argument const&) {
+            // A crash while appending to the file can leave a partial change
+            // chunk at its end so fall back to the chunks before it.
+            auto const whole_size = Document::get_whole_chunks_size(p_data.ptr(), size);
+            if (whole_size == 0 || whole_size == size)
+                throw;
+            m_document.emplace(Document::load(p_data.ptr(), whole_size));
+            WARN_PRINT(vformat("Discarded a partial change chunk of %d bytes from \"%s\".", size - whole_size, p_path));
+            size = whole_size;
+        }
+        // Treat any change chunks that were appended to the file as part of
+        // its snapshot so that they'll be compacted at the same time.
+        m_increments_size = 0;
+        // Replace a file with a partial change chunk rather than append to it.
+        m_saved_path = (size == static_cast<std::size_t>(p_data.size())) ? p_path : String{};
+        m_snapshot_size = size;
     } catch (std::invalid_argument const& thrown) {
         outcome = Error::ERR_INVALID_PARAMETER;
         p_err_msg = thrown.what();
@@ -72,6 +105,28 @@ Error AutomergeResource::load(Vector<std::uint8_t> const& p_data, String& p_err_
     return outcome;
 }
 
+Error AutomergeResource::save(String const& p_path, bool const p_incremental) {
+    ERR_FAIL_COND_V(!m_document, Error::ERR_UNCONFIGURED);
+    auto const filename = globalize_path(p_path);
+    try {
+        // Appending is only valid when the file already holds every change
+        // saved before now.
+        if (p_incremental && p_path == m_saved_path && m_increments_size <= m_snapshot_size &&
+            FileAccess::exists(p_path)) {
+            m_increments_size += m_document->save_incremental(filename);
+        } else {
+            m_snapshot_size = m_document->save(filename);
+            m_increments_size = 0;
+            m_saved_path = p_path;
+        }
+    } catch (std::invalid_argument const& thrown) {
+        ERR_FAIL_V_MSG(Error::ERR_FILE_CANT_WRITE, thrown.what());
+    } catch (std::runtime_error const& thrown) {
+        ERR_FAIL_V_MSG(Error::ERR_FILE_CANT_WRITE, thrown.what());
+    }
+    return Error::OK;
+}
+
 // ResourceFormatLoaderAutomerge
 void ResourceFormatLoaderAutomerge::get_recognized_extensions(List<String>* p_extensions) const {
     p_extensions->push_back(FILE_EXT);
@@ -113,7 +168,7 @@ Ref<Resource> ResourceFormatLoaderAutomerge::load(String const& p_path,
         return Ref<Resource>();
     }
     String load_error_msg;
-    auto load_error = automerge_resource->load(bytes, load_error_msg);
+    auto load_error = automerge_resource->load(p_path, bytes, load_error_msg);
     if (load_error != Error::OK) {
         String error_msg = "Error loading file at \"" + p_path + "\": " + load_error_msg;
         if (r_error) {
@@ -143,21 +198,11 @@ bool ResourceFormatSaverAutomerge::recognize(Ref<Resource> const& p_resource) co
 }
 
 Error ResourceFormatSaverAutomerge::save(Ref<Resource> const& p_resource, String const& p_path, uint32_t p_flags) {
-    using std::filesystem::path;
-
     Ref<AutomergeResource> automerge_resource = p_resource;
     ERR_FAIL_COND_V(!(automerge_resource.is_valid() && automerge_resource->get_document()),
                     Error::ERR_INVALID_PARAMETER);
-    // Convert the project-relative path into an absolute one.
-    auto const global_path = ProjectSettings::get_singleton()->globalize_path(p_path);
-    auto const buffer = global_path.to_utf8_buffer();
-    path const filename{std::string{reinterpret_cast<std::string::const_pointer>(buffer.ptr()),
-                                    static_cast<std::string::size_type>(buffer.size())}};
-    try {
-        automerge_resource->get_document()->get().save(filename);
-    } catch (std::invalid_argument const&) {
-        auto const err = Error::ERR_INVALID_PARAMETER;
-        ERR_FAIL_COND_V_MSG(err, err, "Cannot save file \"" + p_path + "\".");
-    }
+    bool const incremental = GLOBAL_GET(AutomergeResource::INCREMENTAL_SAVE_SETTING);
+    auto const err = automerge_resource->save(p_path, incremental);
+    ERR_FAIL_COND_V_MSG(err != Error::OK, err, "Cannot save file \"" + p_path + "\".");
     return Error::OK;
 }
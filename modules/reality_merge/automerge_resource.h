@@ -50,19 +50,42 @@ class AutomergeResource : public Resource {
     GDCLASS(AutomergeResource, Resource);
 
 public:
-    AutomergeResource() = default;
+    /// \brief The name of the project setting that toggles appending only the
+    ///        latest changes to a file when saving.
+    static char const* const INCREMENTAL_SAVE_SETTING;
+
+    AutomergeResource();
 
     ~AutomergeResource();
 
     std::optional<std::reference_wrapper<cavi::usdj_am::utils::Document const>> get_document() const;
 
-    Error load(Vector<std::uint8_t> const& p_data, String& p_err_msg);
+    /// \param[in] p_path The path of the file that \p p_data was read from.
+    /// \param[in] p_data The contents of a file holding a compacted Automerge
+    ///                   document optionally followed by change chunks.
+    /// \param[out] p_err_msg A description of the error, if any.
+    /// \note A partial change chunk at the end of \p p_data is discarded and
+    ///       the next save replaces the file instead of appending to it.
+    Error load(String const& p_path, Vector<std::uint8_t> const& p_data, String& p_err_msg);
+
+    /// \brief Saves the Automerge document to a file.
+    ///
+    /// \param[in] p_path A path to a file.
+    /// \param[in] p_incremental A toggle for appending only the changes made
+    ///                          since the previous save when \p p_path was its
+    ///                          destination too.
+    /// \note An incremental save compacts the file into a full snapshot once
+    ///       its appended changes outgrow its last snapshot.
+    Error save(String const& p_path, bool const p_incremental);
 
 protected:
     static void _bind_methods();
 
 private:
     std::optional<cavi::usdj_am::utils::Document> m_document;
+    std::uint64_t m_increments_size;
+    String m_saved_path;
+    std::uint64_t m_snapshot_size;
 };
 
 class ResourceFormatLoaderAutomerge : public ResourceFormatLoader {
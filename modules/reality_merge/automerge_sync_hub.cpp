@@ -0,0 +1,96 @@
+/**************************************************************************/
+/* automerge_sync_hub.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <utility>
+
+// regional
+#include <core/config/engine.h>
+#include <core/error/error_macros.h>
+
+// local
+#include "automerge_sync_hub.h"
+
+AutomergeSyncHub* AutomergeSyncHub::s_singleton = nullptr;
+
+AutomergeSyncHub* AutomergeSyncHub::get_singleton() {
+    return s_singleton;
+}
+
+AutomergeSyncHub::AutomergeSyncHub() {
+    s_singleton = this;
+}
+
+AutomergeSyncHub::~AutomergeSyncHub() {
+    if (s_singleton == this)
+        s_singleton = nullptr;
+}
+
+void AutomergeSyncHub::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_channel_count"), &AutomergeSyncHub::get_channel_count);
+}
+
+std::shared_ptr<AutomergeSyncHub::Channel> AutomergeSyncHub::acquire(AMdoc* const p_document,
+                                                                      String const& p_domain_name,
+                                                                      String const& p_path,
+                                                                      SessionFactory const& p_create_session) {
+    ERR_FAIL_NULL_V(p_document, nullptr);
+    // Forget the channels that their last holders have released.
+    for (auto iter = m_channels.begin(); iter != m_channels.end();) {
+        if (iter->second.expired())
+            iter = m_channels.erase(iter);
+        else
+            ++iter;
+    }
+    auto const key = Key{p_document, p_domain_name, p_path};
+    auto found = m_channels.find(key);
+    if (found != m_channels.end())
+        return found->second.lock();
+    auto channel = std::make_shared<Channel>(Channel{p_document, std::nullopt, false, p_create_session()});
+    ERR_FAIL_COND_V(!channel->session, nullptr);
+    m_channels.emplace(key, channel);
+    return channel;
+}
+
+int AutomergeSyncHub::get_channel_count() const {
+    int count = 0;
+    for (auto const& item : m_channels) {
+        if (!item.second.expired())
+            ++count;
+    }
+    return count;
+}
+
+bool AutomergeSyncHub::Channel::receive_changes(std::optional<std::uint64_t> const& p_budget_usecs) {
+    auto const current_frame = Engine::get_singleton()->get_process_frames();
+    if (frame != current_frame) {
+        changed = session->receive_changes(document, p_budget_usecs);
+        frame = current_frame;
+    }
+    return changed;
+}
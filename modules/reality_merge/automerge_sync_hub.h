@@ -0,0 +1,127 @@
+/**************************************************************************/
+/* automerge_sync_hub.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_AUTOMERGE_SYNC_HUB_H
+#define REALITY_MERGE_AUTOMERGE_SYNC_HUB_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
+
+// regional
+#include <core/object/class_db.h>
+#include <core/object/object.h>
+#include <core/string/ustring.h>
+
+// local
+#include "automerge_sync_session.h"
+
+struct AMdoc;
+
+/// \brief An engine singleton that shares one connection to a server among
+///        all of the mediators that synchronize the same Automerge document
+///        with the same document on the server.
+///
+/// \note The protocol identifies a server's document only when the
+///       connection is opened and its sync frames carry no document ID, so
+///       a connection can't carry more than one document. Mediators of
+///       different documents or strates therefore still open one connection
+///       each.
+/// \note The singleton is only consulted when a channel is acquired; its
+///       holders receive changes through the channel itself.
+class AutomergeSyncHub : public Object {
+    GDCLASS(AutomergeSyncHub, Object);
+
+public:
+    /// \brief A connection that's shared by its holders.
+    struct Channel {
+        /// \brief The borrowed Automerge document that's synchronized.
+        AMdoc* document;
+        /// \brief The frame during which the changes were last received.
+        std::optional<std::uint64_t> frame;
+        /// \brief Whether the document was changed during that frame.
+        bool changed;
+        std::unique_ptr<AutomergeSyncSession> session;
+
+        /// \brief Applies the changes received through the channel to its
+        ///        document at most once per frame, regardless of how many
+        ///        holders ask.
+        ///
+        /// \param[in] p_budget_usecs See
+        ///                           `AutomergeSyncSession::receive_changes()`.
+        /// \returns `true` if the document was changed during this frame.
+        bool receive_changes(std::optional<std::uint64_t> const& p_budget_usecs);
+    };
+
+    /// \brief A function that creates a session for a document.
+    using SessionFactory = std::function<std::unique_ptr<AutomergeSyncSession>()>;
+
+    static AutomergeSyncHub* get_singleton();
+
+    AutomergeSyncHub();
+
+    AutomergeSyncHub(AutomergeSyncHub const&) = delete;
+
+    ~AutomergeSyncHub();
+
+    AutomergeSyncHub& operator=(AutomergeSyncHub const&) = delete;
+
+    /// \brief Gets the channel that synchronizes the given Automerge document
+    ///        with the given document on the given server, opening it if it
+    ///        isn't open yet.
+    ///
+    /// \param[in] p_document A pointer to a borrowed Automerge document.
+    /// \param[in] p_domain_name A server's URL domain name component.
+    /// \param[in] p_path A server's URL path component.
+    /// \param[in] p_create_session A function that creates a session when no
+    ///                             channel is open yet.
+    /// \returns A channel that stays open until its last holder releases it.
+    std::shared_ptr<Channel> acquire(AMdoc* const p_document,
+                                     String const& p_domain_name,
+                                     String const& p_path,
+                                     SessionFactory const& p_create_session);
+
+    /// \returns The count of open channels.
+    int get_channel_count() const;
+
+protected:
+    static void _bind_methods();
+
+private:
+    using Key = std::tuple<AMdoc*, String, String>;
+
+    std::map<Key, std::weak_ptr<Channel>> m_channels;
+
+    static AutomergeSyncHub* s_singleton;
+};
+
+#endif  // REALITY_MERGE_AUTOMERGE_SYNC_HUB_H
@@ -0,0 +1,264 @@
+/**************************************************************************/
+/* automerge_sync_server.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// regional
+#include <core/error/error_macros.h>
+#include <core/io/ip_address.h>
+#include <core/io/stream_peer_tcp.h>
+#include <core/templates/vector.h>
+#include <core/variant/dictionary.h>
+
+// local
+#include "automerge_sync_server.h"
+
+namespace {
+
+static int const BUFFER_SIZE = (1 << 23) - 1;
+
+/// \brief The signifier byte prepended to a binary Automerge sync message.
+static std::uint8_t const SYNC_MESSAGE_TYPE = 0;
+
+/// \brief Gets the change hashes within a result as a sorted sequence of byte
+///        strings.
+std::vector<std::string> to_hashes(AMresult* const p_result) {
+    std::vector<std::string> hashes{};
+    AMitems items = AMresultItems(p_result);
+    AMitem* item = nullptr;
+    while ((item = AMitemsNext(&items, 1)) != nullptr) {
+        AMbyteSpan hash = {0};
+        if (AMitemToChangeHash(item, &hash))
+            hashes.emplace_back(reinterpret_cast<char const*>(hash.src), hash.count);
+    }
+    std::sort(hashes.begin(), hashes.end());
+    return hashes;
+}
+
+}  // namespace
+
+AutomergeSyncServer::AutomergeSyncServer() {
+    m_json_parser.instantiate();
+    m_tcp_server.instantiate();
+}
+
+AutomergeSyncServer::~AutomergeSyncServer() {
+    stop();
+}
+
+void AutomergeSyncServer::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("generate_changes", "strate_id", "count"), &AutomergeSyncServer::generate_changes);
+    ClassDB::bind_method(D_METHOD("get_peer_count"), &AutomergeSyncServer::get_peer_count);
+    ClassDB::bind_method(D_METHOD("is_synced", "strate_id"), &AutomergeSyncServer::is_synced);
+    ClassDB::bind_method(D_METHOD("listen", "port", "bind_address"), &AutomergeSyncServer::listen,
+                         DEFVAL("127.0.0.1"));
+    ClassDB::bind_method(D_METHOD("poll"), &AutomergeSyncServer::poll);
+    ClassDB::bind_method(D_METHOD("stop"), &AutomergeSyncServer::stop);
+}
+
+int AutomergeSyncServer::generate_changes(String const& p_strate_id, int const p_count) {
+    auto& document = get_strate(p_strate_id);
+    int count = 0;
+    for (; count < p_count; ++count) {
+        // Each commit is a separate change.
+        ResultPtr const put_result{AMmapPutInt(document, AM_ROOT, AMstr("counter"), count), AMresultFree};
+        ERR_BREAK(AMresultStatus(put_result.get()) != AM_STATUS_OK);
+        ResultPtr const commit_result{AMcommit(document, AMstr(nullptr), nullptr), AMresultFree};
+        ERR_BREAK(AMresultStatus(commit_result.get()) != AM_STATUS_OK);
+    }
+    touch(p_strate_id);
+    return count;
+}
+
+int AutomergeSyncServer::get_peer_count() const {
+    return static_cast<int>(m_peers.size());
+}
+
+cavi::usdj_am::utils::Document& AutomergeSyncServer::get_strate(String const& p_strate_id) {
+    using cavi::usdj_am::utils::Document;
+
+    auto found = m_strates.find(p_strate_id);
+    if (found == m_strates.end())
+        found = m_strates.emplace(p_strate_id, Document{ResultPtr{AMcreate(nullptr), AMresultFree}}).first;
+    return found->second;
+}
+
+bool AutomergeSyncServer::is_synced(String const& p_strate_id) const {
+    auto const found = m_strates.find(p_strate_id);
+    if (found == m_strates.end())
+        return false;
+    ResultPtr const heads_result{AMgetHeads(found->second), AMresultFree};
+    auto const heads = to_hashes(heads_result.get());
+    bool opened = false;
+    for (auto const& peer : m_peers) {
+        if (peer.strate_id != p_strate_id)
+            continue;
+        AMsyncState* sync_state = nullptr;
+        if (!AMitemToSyncState(AMresultItem(peer.sync_state_result.get()), &sync_state))
+            return false;
+        ResultPtr const their_heads_result{AMsyncStateTheirHeads(sync_state), AMresultFree};
+        if (to_hashes(their_heads_result.get()) != heads)
+            return false;
+        opened = true;
+    }
+    return opened;
+}
+
+Error AutomergeSyncServer::listen(int const p_port, String const& p_bind_address) {
+    stop();
+    return m_tcp_server->listen(p_port, IPAddress(p_bind_address));
+}
+
+void AutomergeSyncServer::poll() {
+    while (m_tcp_server->is_listening() && m_tcp_server->is_connection_available()) {
+        Ref<StreamPeerTCP> const stream = m_tcp_server->take_connection();
+        if (stream.is_null())
+            break;
+        Ref<WebSocketPeer> socket = Ref<WebSocketPeer>(WebSocketPeer::create());
+        ERR_FAIL_COND(socket.is_null());
+        Vector<String> protocols;
+        protocols.push_back("binary");
+        socket->set_supported_protocols(protocols);
+        socket->set_inbound_buffer_size(BUFFER_SIZE);
+        socket->set_outbound_buffer_size(BUFFER_SIZE);
+        ERR_CONTINUE(socket->accept_stream(stream) != OK);
+        m_peers.push_back(Peer{socket, String{}, ResultPtr{AMsyncStateInit(), AMresultFree}, false});
+    }
+    for (auto peer = m_peers.begin(); peer != m_peers.end();) {
+        peer->socket->poll();
+        switch (peer->socket->get_ready_state()) {
+            case WebSocketPeer::STATE_OPEN: {
+                receive(*peer);
+                break;
+            }
+            case WebSocketPeer::STATE_CLOSED: {
+                peer = m_peers.erase(peer);
+                continue;
+            }
+            default:
+                break;
+        }
+        ++peer;
+    }
+    for (auto& peer : m_peers) {
+        if (peer.stale && peer.socket->get_ready_state() == WebSocketPeer::STATE_OPEN)
+            send_sync_message(peer);
+    }
+}
+
+void AutomergeSyncServer::receive(Peer& p_peer) {
+    auto packet_count = p_peer.socket->get_available_packet_count();
+    while (packet_count--) {
+        std::uint8_t const* r_buffer = nullptr;
+        int r_buffer_size = 0;
+        ERR_FAIL_COND(p_peer.socket->get_packet(&r_buffer, r_buffer_size) != OK);
+        if (r_buffer_size <= 0)
+            continue;
+        if (p_peer.socket->was_string_packet()) {
+            String const json_string = String::utf8(reinterpret_cast<char const*>(r_buffer), r_buffer_size);
+            if (m_json_parser->parse(json_string) == OK)
+                receive_text(p_peer, m_json_parser->get_data());
+        } else if (r_buffer[0] == SYNC_MESSAGE_TYPE && !p_peer.strate_id.is_empty()) {
+            ResultPtr const decode_result{AMsyncMessageDecode(r_buffer + 1, r_buffer_size - 1), AMresultFree};
+            AMsyncMessage const* message = nullptr;
+            ERR_CONTINUE(!AMitemToSyncMessage(AMresultItem(decode_result.get()), &message));
+            AMsyncState* sync_state = nullptr;
+            ERR_CONTINUE(!AMitemToSyncState(AMresultItem(p_peer.sync_state_result.get()), &sync_state));
+            ResultPtr const receive_result{
+                AMreceiveSyncMessage(get_strate(p_peer.strate_id), sync_state, message), AMresultFree};
+            ERR_CONTINUE(AMresultStatus(receive_result.get()) != AM_STATUS_OK);
+            // The client's changes may be news to the document's other clients.
+            touch(p_peer.strate_id);
+        }
+    }
+}
+
+void AutomergeSyncServer::receive_text(Peer& p_peer, Variant const& p_message) {
+    if (p_message.get_type() != Variant::DICTIONARY)
+        return;
+    Dictionary const message = p_message;
+    if (message.get("wa", "") == Variant("open")) {
+        Dictionary const body = message.get("body", Dictionary{});
+        String const strate_id = body.get("strateId", "");
+        ERR_FAIL_COND_MSG(strate_id.is_empty(), "A client opened a document without an ID.");
+        get_strate(strate_id);
+        p_peer.strate_id = strate_id;
+        p_peer.sync_state_result = ResultPtr{AMsyncStateInit(), AMresultFree};
+        p_peer.stale = true;
+    } else if (message.has("ping")) {
+        Dictionary reply{};
+        reply["pong"] = message["ping"];
+        p_peer.socket->send_text(m_json_parser->stringify(reply, "\t", false));
+    }
+}
+
+void AutomergeSyncServer::send_sync_message(Peer& p_peer) {
+    p_peer.stale = false;
+    if (p_peer.strate_id.is_empty())
+        return;
+    AMsyncState* sync_state = nullptr;
+    ERR_FAIL_COND(!AMitemToSyncState(AMresultItem(p_peer.sync_state_result.get()), &sync_state));
+    ResultPtr const generate_result{AMgenerateSyncMessage(get_strate(p_peer.strate_id), sync_state), AMresultFree};
+    AMsyncMessage const* message = nullptr;
+    // There's nothing to send until the client replies.
+    if (!AMitemToSyncMessage(AMresultItem(generate_result.get()), &message))
+        return;
+    ResultPtr const encode_result{AMsyncMessageEncode(message), AMresultFree};
+    AMbyteSpan bytes = {0};
+    ERR_FAIL_COND(!AMitemToBytes(AMresultItem(encode_result.get()), &bytes));
+    // Prepend a message type signifier byte.
+    std::vector<std::uint8_t> buffer{SYNC_MESSAGE_TYPE};
+    buffer.reserve(buffer.size() + bytes.count);
+    buffer.insert(buffer.end(), bytes.src, bytes.src + bytes.count);
+    ERR_FAIL_COND(p_peer.socket->put_packet(buffer.data(), buffer.size()) != OK);
+}
+
+void AutomergeSyncServer::stop() {
+    for (auto& peer : m_peers)
+        peer.socket->close();
+    m_peers.clear();
+    m_tcp_server->stop();
+}
+
+void AutomergeSyncServer::touch(String const& p_strate_id) {
+    for (auto& peer : m_peers) {
+        if (peer.strate_id == p_strate_id)
+            peer.stale = true;
+    }
+}
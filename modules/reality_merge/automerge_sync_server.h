@@ -0,0 +1,134 @@
+/**************************************************************************/
+/* automerge_sync_server.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_AUTOMERGE_SYNC_SERVER_H
+#define REALITY_MERGE_AUTOMERGE_SYNC_SERVER_H
+
+#include <list>
+#include <map>
+
+// third-party
+#include <cavi/usdj_am/utils/document.hpp>
+
+// regional
+#include <core/error/error_list.h>
+#include <core/io/json.h>
+#include <core/io/tcp_server.h>
+#include <core/object/ref_counted.h>
+#include <core/string/ustring.h>
+#include <modules/websocket/websocket_peer.h>
+
+/// \brief A stand-in for an Automerge sync server that speaks the same
+///        protocol over plain WebSockets so that the synchronization of a
+///        `UsdjMediator` can be tested and benchmarked without a network.
+///
+/// \note The documents that it serves only exist in memory.
+/// \note It's only available within the editor build.
+class AutomergeSyncServer : public RefCounted {
+    GDCLASS(AutomergeSyncServer, RefCounted);
+
+public:
+    AutomergeSyncServer();
+
+    AutomergeSyncServer(AutomergeSyncServer const&) = delete;
+
+    ~AutomergeSyncServer();
+
+    AutomergeSyncServer& operator=(AutomergeSyncServer const&) = delete;
+
+    /// \brief Makes changes to a document that the server serves, creating it
+    ///        if it doesn't exist yet.
+    ///
+    /// \param[in] p_strate_id The ID of a document on the server.
+    /// \param[in] p_count The count of changes to make.
+    /// \returns The count of changes that were made.
+    /// \note Calling this before any peer connects builds a large initial
+    ///       history whereas calling it every frame simulates a steady stream
+    ///       of changes.
+    int generate_changes(String const& p_strate_id, int const p_count);
+
+    /// \returns The count of peers connected to the server.
+    int get_peer_count() const;
+
+    /// \param[in] p_strate_id The ID of a document on the server.
+    /// \returns `true` if at least one peer has opened the document and every
+    ///          peer that has opened it has all of its changes.
+    bool is_synced(String const& p_strate_id) const;
+
+    /// \brief Starts accepting connections.
+    ///
+    /// \param[in] p_port A TCP port number.
+    /// \param[in] p_bind_address The IP address of a local interface.
+    Error listen(int const p_port, String const& p_bind_address = "127.0.0.1");
+
+    /// \brief Accepts pending connections and exchanges pending messages.
+    void poll();
+
+    /// \brief Disconnects all peers and stops accepting connections.
+    void stop();
+
+protected:
+    static void _bind_methods();
+
+private:
+    using ResultPtr = cavi::usdj_am::utils::Document::ResultPtr;
+
+    /// \brief A connection to a client.
+    struct Peer {
+        Ref<WebSocketPeer> socket;
+        /// \brief The ID of the document that the client opened, if any.
+        String strate_id;
+        ResultPtr sync_state_result;
+        /// \brief Whether the client might be missing changes.
+        bool stale;
+    };
+
+    /// \brief Gets a document that the server serves, creating it if it
+    ///        doesn't exist yet.
+    cavi::usdj_am::utils::Document& get_strate(String const& p_strate_id);
+
+    /// \brief Handles the messages received from a client.
+    void receive(Peer& p_peer);
+
+    /// \brief Handles a text message received from a client.
+    void receive_text(Peer& p_peer, Variant const& p_message);
+
+    /// \brief Sends a client a sync message for its document, if needed.
+    void send_sync_message(Peer& p_peer);
+
+    /// \brief Marks every client of a document as possibly missing changes.
+    void touch(String const& p_strate_id);
+
+    Ref<JSON> m_json_parser;
+    std::list<Peer> m_peers;
+    std::map<String, cavi::usdj_am::utils::Document> m_strates;
+    Ref<TCPServer> m_tcp_server;
+};
+
+#endif  // REALITY_MERGE_AUTOMERGE_SYNC_SERVER_H
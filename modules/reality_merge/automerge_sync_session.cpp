@@ -0,0 +1,394 @@
+/**************************************************************************/
+/* automerge_sync_session.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// regional
+#include <core/config/project_settings.h>
+#include <core/error/error_macros.h>
+#include <core/io/file_access.h>
+#include <core/os/os.h>
+#include <core/templates/vector.h>
+#include <core/variant/dictionary.h>
+
+// local
+#include "automerge_sync_session.h"
+
+namespace {
+
+static int const BUFFER_SIZE = (1 << 23) - 1;
+
+/// \brief The signifier byte prepended to a binary Automerge sync message.
+static std::uint8_t const SYNC_MESSAGE_TYPE = 0;
+
+}  // namespace
+
+AutomergeSyncSession::AutomergeSyncSession(String const& p_domain_name, String const& p_path, String const& p_peer_id)
+    : m_attempts{0},
+      m_connect_msecs{0},
+      m_domain_name{p_domain_name},
+      m_heartbeat_msecs{HEARTBEAT_INTERVAL_MSECS},
+      m_init_syncing{false},
+      m_max_queued_packets{static_cast<int>(GLOBAL_GET("network/limits/debugger/max_queued_messages"))},
+      m_path{p_path},
+      m_peer_id{p_peer_id},
+      m_random{std::random_device{}()},
+      m_retry_msecs{0},
+      m_round_trip_msecs{-1},
+      m_state{State::DISCONNECTED},
+      m_sync_state_msecs{0},
+      m_sync_state_result{AMsyncStateInit(), AMresultFree},
+      m_traffic_msecs{0} {
+    m_json_parser.instantiate();
+    Dictionary request{};
+    request["ping"] = "ping";
+    m_ping_text = m_json_parser->stringify(request, "\t", false);
+}
+
+AutomergeSyncSession::~AutomergeSyncSession() {
+    close();
+}
+
+void AutomergeSyncSession::back_off(std::uint64_t const p_now) {
+    close();
+    // Double the delay after each consecutive failure and then pick one
+    // somewhere in its upper half so that a crowd of clients that lost their
+    // connections simultaneously won't reconnect simultaneously.
+    auto const exponential = BACKOFF_BASE_MSECS << std::min(m_attempts, std::uint32_t{16});
+    auto const ceiling = (exponential < BACKOFF_MAX_MSECS) ? exponential : BACKOFF_MAX_MSECS;
+    std::uniform_int_distribution<std::uint64_t> jitter{ceiling / 2, ceiling};
+    m_retry_msecs = p_now + jitter(m_random);
+    ++m_attempts;
+    m_state = State::BACKOFF;
+}
+
+void AutomergeSyncSession::close() {
+    if (m_state == State::SYNCING || m_state == State::IDLE)
+        save_sync_state(OS::get_singleton()->get_ticks_msec());
+    if (!m_socket.is_null()) {
+        m_socket->close();
+        m_socket.unref();
+    }
+    m_state = State::DISCONNECTED;
+}
+
+void AutomergeSyncSession::connect(std::uint64_t const p_now) {
+    m_socket = Ref<WebSocketPeer>(WebSocketPeer::create());
+    if (m_socket.is_null()) {
+        back_off(p_now);
+        ERR_FAIL_MSG("Unable to create a WebSocket.");
+    }
+    Vector<String> protocols;
+    protocols.push_back("binary");
+    m_socket->set_supported_protocols(protocols);
+    m_socket->set_max_queued_packets(m_max_queued_packets);
+    m_socket->set_inbound_buffer_size(BUFFER_SIZE);
+    m_socket->set_outbound_buffer_size(BUFFER_SIZE);
+    // A domain name that's prefixed with a scheme, e.g. "ws://localhost:8080"
+    // for a loopback server, is already a URL.
+    auto const url = (m_domain_name.begins_with("ws://") || m_domain_name.begins_with("wss://"))
+                         ? m_domain_name
+                         : String{"wss://"} + m_domain_name;
+    if (m_socket->connect_to_url(url, TLSOptions::client()) != OK) {
+        back_off(p_now);
+        ERR_FAIL_MSG(vformat("Unable to connect to server \"%s\".", m_domain_name));
+    }
+    m_connect_msecs = p_now;
+    m_state = State::CONNECTING;
+}
+
+Error AutomergeSyncSession::heartbeat() {
+    if (!(m_state == State::SYNCING || m_state == State::IDLE))
+        return OK;
+    auto const now = OS::get_singleton()->get_ticks_msec();
+    auto const interval = get_heartbeat_interval();
+    // Any traffic proves that the connection is alive.
+    if (now - m_traffic_msecs < interval)
+        return OK;
+    // An unanswered keepalive message may just be slow.
+    if (m_ping_msecs && now - *m_ping_msecs < interval)
+        return OK;
+    ERR_FAIL_COND_V(m_socket->send_text(m_ping_text) != OK, FAILED);
+    m_ping_msecs = now;
+    return OK;
+}
+
+void AutomergeSyncSession::open_document(std::uint64_t const p_now) {
+    // Disable Nagle's algorithm.
+    m_socket->set_no_delay(true);
+    // Request updates of the Automerge document.
+    Dictionary request{};
+    request["wa"] = "open";
+    Dictionary body{};
+    body["strateId"] = m_path;
+    body["peerId"] = m_peer_id;
+    request["body"] = body;
+    if (m_socket->send_text(m_json_parser->stringify(request, "\t", false)) != OK) {
+        back_off(p_now);
+        ERR_FAIL_MSG(vformat("Unable to request document \"%s\" from server \"%s\".", m_path, m_domain_name));
+    }
+    // The server has forgotten whatever it told us over a previous connection
+    // so only the durable part of the synchronization state remains valid.
+    AMsyncState* sync_state = nullptr;
+    if (AMitemToSyncState(AMresultItem(m_sync_state_result.get()), &sync_state)) {
+        ResultPtr const encode_result{AMsyncStateEncode(sync_state), AMresultFree};
+        AMbyteSpan bytes = {0};
+        if (AMitemToBytes(AMresultItem(encode_result.get()), &bytes)) {
+            ResultPtr decode_result{AMsyncStateDecode(bytes.src, bytes.count), AMresultFree};
+            if (AMresultStatus(decode_result.get()) == AM_STATUS_OK)
+                m_sync_state_result = std::move(decode_result);
+        }
+    }
+    m_init_syncing = true;
+    m_ping_msecs.reset();
+    m_traffic_msecs = p_now;
+    m_state = State::HANDSHAKING;
+}
+
+AutomergeSyncSession::State AutomergeSyncSession::poll() {
+    auto const now = OS::get_singleton()->get_ticks_msec();
+    switch (m_state) {
+        case State::BACKOFF: {
+            if (now < m_retry_msecs)
+                break;
+            connect(now);
+            break;
+        }
+        case State::DISCONNECTED: {
+            connect(now);
+            break;
+        }
+        case State::CONNECTING: {
+            m_socket->poll();
+            switch (m_socket->get_ready_state()) {
+                case WebSocketPeer::STATE_CONNECTING: {
+                    if (now - m_connect_msecs >= HANDSHAKE_TIMEOUT_MSECS) {
+                        back_off(now);
+                        ERR_PRINT(vformat("Timed out connecting to server \"%s\".", m_domain_name));
+                    }
+                    break;
+                }
+                case WebSocketPeer::STATE_OPEN: {
+                    open_document(now);
+                    break;
+                }
+                default: {
+                    back_off(now);
+                    ERR_PRINT(vformat("Unable to connect to server \"%s\".", m_domain_name));
+                    break;
+                }
+            }
+            break;
+        }
+        case State::HANDSHAKING:
+        case State::SYNCING:
+        case State::IDLE: {
+            m_socket->poll();
+            switch (m_socket->get_ready_state()) {
+                case WebSocketPeer::STATE_OPEN: {
+                    if (m_state == State::HANDSHAKING && now - m_connect_msecs >= HANDSHAKE_TIMEOUT_MSECS) {
+                        back_off(now);
+                        ERR_PRINT(vformat("Timed out waiting for server \"%s\" to reply.", m_domain_name));
+                    }
+                    break;
+                }
+                case WebSocketPeer::STATE_CLOSING:
+                    // Keep polling until it's closed.
+                    break;
+                default: {
+                    auto const code = m_socket->get_close_code();
+                    auto const reason = m_socket->get_close_reason();
+                    WARN_PRINT(vformat("WebSocket closed with code %d and reason \"%s\".", code, reason));
+                    back_off(now);
+                    break;
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return m_state;
+}
+
+bool AutomergeSyncSession::receive_changes(AMdoc* const p_document,
+                                           std::optional<std::uint64_t> const& p_budget_usecs) {
+    switch (poll()) {
+        case State::HANDSHAKING:
+        case State::SYNCING:
+        case State::IDLE:
+            break;
+        default:
+            return false;
+    }
+    if (m_socket->get_ready_state() != WebSocketPeer::STATE_OPEN)
+        return false;
+    auto const now = OS::get_singleton()->get_ticks_msec();
+    auto const start_usecs = OS::get_singleton()->get_ticks_usec();
+    bool result = false;
+    AMsyncState* client_state = nullptr;
+    ERR_FAIL_COND_V(!AMitemToSyncState(AMresultItem(m_sync_state_result.get()), &client_state), false);
+    auto packet_count = m_socket->get_available_packet_count();
+    if (packet_count) {
+        // The server is responsive so the next failure starts a new series.
+        m_attempts = 0;
+        m_state = State::SYNCING;
+        m_traffic_msecs = now;
+    } else if (m_state == State::SYNCING && !m_init_syncing) {
+        m_state = State::IDLE;
+        // Checkpoint the synchronization state whenever the server goes quiet.
+        if (now - m_sync_state_msecs >= SYNC_STATE_SAVE_PERIOD_MSECS)
+            save_sync_state(now);
+    }
+    while (packet_count && m_socket->get_ready_state() == WebSocketPeer::STATE_OPEN) {
+        std::uint8_t const* r_buffer = nullptr;
+        int r_buffer_size = 0;
+        auto const error = m_socket->get_packet(&r_buffer, r_buffer_size);
+        ERR_FAIL_COND_V(error != OK, false);
+        ERR_FAIL_COND_V(r_buffer_size <= 0, false);
+        // Classify the message by its WebSocket opcode and then by its type
+        // signifier byte so that a sync message is never parsed as JSON.
+        bool const binary = !m_socket->was_string_packet();
+        if (binary && r_buffer[0] == SYNC_MESSAGE_TYPE) {
+            // Decode the payload in place.
+            result = receive_sync_message(p_document, client_state, r_buffer + 1, r_buffer_size - 1) || result;
+        } else {
+            // A binary message of any other type may still carry JSON.
+            String const json_string = String::utf8(reinterpret_cast<char const*>(r_buffer), r_buffer_size);
+            if (m_json_parser->parse(json_string) == OK) {
+                receive_text(m_json_parser->get_data(), now);
+            } else if (binary) {
+                WARN_PRINT_ONCE(vformat("Ignoring a binary message of unknown type %d.", r_buffer[0]));
+            }
+        }
+        --packet_count;
+        // Leave the rest of a burst for subsequent frames so that catching up
+        // with the server can't stall this one.
+        if (p_budget_usecs && OS::get_singleton()->get_ticks_usec() - start_usecs >= *p_budget_usecs)
+            break;
+    }
+    if (result || m_init_syncing) {
+        ResultPtr const generate_result{AMgenerateSyncMessage(p_document, client_state), AMresultFree};
+        AMsyncMessage const* client_message = nullptr;
+        if (AMitemToSyncMessage(AMresultItem(generate_result.get()), &client_message)) {
+            ResultPtr const encode_result{AMsyncMessageEncode(client_message), AMresultFree};
+            AMbyteSpan client_message_bytes = {0};
+            ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(encode_result.get()), &client_message_bytes), false);
+            // Prepend a message type signifier byte.
+            std::vector<std::uint8_t> client_buffer{SYNC_MESSAGE_TYPE};
+            client_buffer.reserve(client_buffer.size() + client_message_bytes.count);
+            client_buffer.insert(client_buffer.end(), client_message_bytes.src,
+                                 client_message_bytes.src + client_message_bytes.count);
+            ERR_FAIL_COND_V(m_socket->put_packet(client_buffer.data(), client_buffer.size()) != OK, false);
+            m_init_syncing = false;
+            m_traffic_msecs = now;
+        }
+    }
+    return result;
+}
+
+bool AutomergeSyncSession::receive_sync_message(AMdoc* const p_document,
+                                                AMsyncState* const p_sync_state,
+                                                std::uint8_t const* const p_src,
+                                                std::size_t const p_count) {
+    ResultPtr const decode_result{AMsyncMessageDecode(p_src, p_count), AMresultFree};
+    AMsyncMessage const* server_message = nullptr;
+    if (!AMitemToSyncMessage(AMresultItem(decode_result.get()), &server_message))
+        return false;
+    ResultPtr const receive_result{AMreceiveSyncMessage(p_document, p_sync_state, server_message), AMresultFree};
+    ERR_FAIL_COND_V(AMresultStatus(receive_result.get()) != AM_STATUS_OK, false);
+    return true;
+}
+
+void AutomergeSyncSession::receive_text(Variant const& p_message, std::uint64_t const p_now) {
+    // Only a reply to a keepalive message is of interest.
+    if (!m_ping_msecs || p_message.get_type() != Variant::DICTIONARY)
+        return;
+    Dictionary const message = p_message;
+    if (!(message.has("pong") || message.has("ping")))
+        return;
+    auto const sample = static_cast<std::int64_t>(p_now - *m_ping_msecs);
+    auto const smoothed = get_round_trip_msecs();
+    // Smooth the samples the way that TCP does (RFC 6298).
+    m_round_trip_msecs.store((smoothed < 0) ? sample : (7 * smoothed + sample) / 8, std::memory_order_relaxed);
+    m_ping_msecs.reset();
+}
+
+Error AutomergeSyncSession::restore_sync_state(AMdoc* const p_document, String const& p_path) {
+    m_sync_state_path = p_path;
+    if (!FileAccess::exists(p_path))
+        return ERR_FILE_NOT_FOUND;
+    Error error = OK;
+    Vector<std::uint8_t> const bytes = FileAccess::get_file_as_bytes(p_path, &error);
+    ERR_FAIL_COND_V(error != OK, error);
+    ResultPtr decode_result{AMsyncStateDecode(bytes.ptr(), bytes.size()), AMresultFree};
+    AMsyncState* sync_state = nullptr;
+    ERR_FAIL_COND_V_MSG(!AMitemToSyncState(AMresultItem(decode_result.get()), &sync_state), ERR_FILE_CORRUPT,
+                        vformat("Unable to decode the synchronization state in \"%s\".", p_path));
+    // A synchronization state that's ahead of the document, e.g. because the
+    // document wasn't saved after its last session, would keep the server from
+    // sending the missing changes.
+    ResultPtr const heads_result{AMsyncStateSharedHeads(sync_state), AMresultFree};
+    AMitems heads = AMresultItems(heads_result.get());
+    AMitem* head = nullptr;
+    while ((head = AMitemsNext(&heads, 1)) != nullptr) {
+        AMbyteSpan hash = {0};
+        ERR_FAIL_COND_V(!AMitemToChangeHash(head, &hash), ERR_FILE_CORRUPT);
+        ResultPtr const change_result{AMgetChangeByHash(p_document, hash.src, hash.count), AMresultFree};
+        if (AMitemValType(AMresultItem(change_result.get())) != AM_VAL_TYPE_CHANGE)
+            return ERR_FILE_MISSING_DEPENDENCIES;
+    }
+    m_sync_state_result = std::move(decode_result);
+    return OK;
+}
+
+Error AutomergeSyncSession::save_sync_state(std::uint64_t const p_now) {
+    if (m_sync_state_path.is_empty())
+        return OK;
+    AMsyncState* sync_state = nullptr;
+    ERR_FAIL_COND_V(!AMitemToSyncState(AMresultItem(m_sync_state_result.get()), &sync_state), ERR_BUG);
+    ResultPtr const encode_result{AMsyncStateEncode(sync_state), AMresultFree};
+    AMbyteSpan bytes = {0};
+    ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(encode_result.get()), &bytes), ERR_BUG);
+    Error error = OK;
+    auto file = FileAccess::open(m_sync_state_path, FileAccess::WRITE, &error);
+    ERR_FAIL_COND_V_MSG(file.is_null(), error,
+                        vformat("Unable to save the synchronization state to \"%s\".", m_sync_state_path));
+    file->store_buffer(bytes.src, bytes.count);
+    m_sync_state_msecs = p_now;
+    return OK;
+}
@@ -0,0 +1,255 @@
+/**************************************************************************/
+/* automerge_sync_session.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_AUTOMERGE_SYNC_SESSION_H
+#define REALITY_MERGE_AUTOMERGE_SYNC_SESSION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+
+// third-party
+#include <cavi/usdj_am/utils/document.hpp>
+
+// regional
+#include <core/error/error_list.h>
+#include <core/io/json.h>
+#include <core/object/ref_counted.h>
+#include <core/string/ustring.h>
+#include <core/variant/variant.h>
+#include <modules/websocket/websocket_peer.h>
+
+struct AMdoc;
+struct AMsyncState;
+
+/// \brief A connection to a server through which an Automerge document is kept
+///        synchronized with the server's copy of it.
+///
+/// \note A session isn't thread-safe but it can be handed off to another
+///       thread after it has been constructed.
+/// \note A session never blocks on the network; its connection advances a
+///       step at a time whenever it's polled.
+class AutomergeSyncSession {
+public:
+    /// \brief The states of a session's connection to the server.
+    enum class State : std::uint8_t {
+        BEGIN__ = 1,
+        /// \brief There's no connection.
+        DISCONNECTED = BEGIN__,
+        /// \brief The WebSocket connection is being opened.
+        CONNECTING,
+        /// \brief The document has been requested but the server hasn't
+        ///        replied yet.
+        HANDSHAKING,
+        /// \brief Synchronization messages are being exchanged.
+        SYNCING,
+        /// \brief The connection is open but quiet.
+        IDLE,
+        /// \brief The connection failed and is waiting to be retried.
+        BACKOFF,
+        END__,
+        SIZE__ = END__ - BEGIN__
+    };
+
+    /// \brief The minimum delay before reconnecting after a failure.
+    static std::uint64_t const BACKOFF_BASE_MSECS = 500;
+
+    /// \brief The maximum delay before reconnecting after a failure.
+    static std::uint64_t const BACKOFF_MAX_MSECS = 30000;
+
+    /// \brief The maximum delay between starting to connect and receiving the
+    ///        server's first reply.
+    static std::uint64_t const HANDSHAKE_TIMEOUT_MSECS = 6000;
+
+    /// \brief The minimum period between saves of the synchronization state
+    ///        while the connection remains open.
+    static std::uint64_t const SYNC_STATE_SAVE_PERIOD_MSECS = 5000;
+
+    /// \brief The default period of silence after which a keepalive message
+    ///        is sent.
+    static std::uint64_t const HEARTBEAT_INTERVAL_MSECS = 5000;
+
+    AutomergeSyncSession() = delete;
+
+    /// \param[in] p_domain_name A server's URL domain name component,
+    ///                          optionally prefixed with a `ws://` or `wss://`
+    ///                          scheme and suffixed with a port number.
+    /// \param[in] p_path A server's URL path component.
+    /// \param[in] p_peer_id A UUID identifying this peer to the server.
+    AutomergeSyncSession(String const& p_domain_name, String const& p_path, String const& p_peer_id);
+
+    AutomergeSyncSession(AutomergeSyncSession const&) = delete;
+
+    ~AutomergeSyncSession();
+
+    AutomergeSyncSession& operator=(AutomergeSyncSession const&) = delete;
+
+    /// \brief Closes the connection to the server, if any, and saves the
+    ///        synchronization state.
+    void close();
+
+    /// \returns The period of silence after which a keepalive message is
+    ///          sent.
+    /// \note It's safe to call this from any thread.
+    std::uint64_t get_heartbeat_interval() const;
+
+    /// \returns The smoothed round-trip time of the keepalive messages or
+    ///          `-1` if none of them has been answered yet.
+    /// \note It's safe to call this from any thread.
+    std::int64_t get_round_trip_msecs() const;
+
+    /// \returns The state of the connection to the server.
+    State get_state() const;
+
+    /// \brief Sends a keepalive message if the connection has been silent for
+    ///        the heartbeat interval and the previous one was answered or has
+    ///        gone unanswered for as long.
+    ///
+    /// \returns `Error::OK` unless a due keepalive message couldn't be sent.
+    Error heartbeat();
+
+    /// \brief Advances the connection to the server by at most one step.
+    ///
+    /// \returns The state of the connection to the server.
+    State poll();
+
+    /// \brief Applies the synchronization messages received from the server to
+    ///        the given Automerge document and replies to them.
+    ///
+    /// \param[in,out] p_document A pointer to a borrowed Automerge document.
+    /// \param[in] p_budget_usecs The time in microseconds after which the
+    ///                           messages still pending are left for the next
+    ///                           call or `std::nullopt` to apply all of them.
+    /// \returns `true` if \p p_document was changed.
+    /// \note At least one pending message is applied per call regardless of
+    ///       \p p_budget_usecs.
+    bool receive_changes(AMdoc* const p_document, std::optional<std::uint64_t> const& p_budget_usecs = std::nullopt);
+
+    /// \brief Restores what was learned about the server's copy of the
+    ///        Automerge document during a previous session and remembers where
+    ///        to save it for the next one.
+    ///
+    /// \param[in] p_document A pointer to a borrowed Automerge document.
+    /// \param[in] p_path The path to a file of an encoded synchronization
+    ///                   state.
+    /// \returns `Error::OK` if the synchronization state was restored.
+    /// \note The synchronization state is only restored if \p p_document
+    ///       contains every change that it claims to share with the server.
+    Error restore_sync_state(AMdoc* const p_document, String const& p_path);
+
+    /// \param[in] p_msecs A period of silence after which a keepalive
+    ///                    message is sent.
+    /// \note It's safe to call this from any thread.
+    void set_heartbeat_interval(std::uint64_t const p_msecs);
+
+private:
+    using ResultPtr = cavi::usdj_am::utils::Document::ResultPtr;
+
+    /// \brief Closes the connection and schedules an attempt to reopen it.
+    ///
+    /// \param[in] p_now The current time in milliseconds.
+    void back_off(std::uint64_t const p_now);
+
+    /// \brief Starts opening a connection to the server.
+    ///
+    /// \param[in] p_now The current time in milliseconds.
+    void connect(std::uint64_t const p_now);
+
+    /// \brief Requests updates of the Automerge document from the server.
+    ///
+    /// \param[in] p_now The current time in milliseconds.
+    void open_document(std::uint64_t const p_now);
+
+    /// \brief Applies a binary Automerge sync message received from the server
+    ///        to the given Automerge document.
+    ///
+    /// \param[in,out] p_document A pointer to a borrowed Automerge document.
+    /// \param[in,out] p_sync_state A pointer to a borrowed sync state.
+    /// \param[in] p_src A pointer to the message's bytes without their type
+    ///                  signifier byte.
+    /// \param[in] p_count The count of bytes at \p p_src.
+    /// \returns `true` if the message was applied to \p p_document.
+    bool receive_sync_message(AMdoc* const p_document,
+                              AMsyncState* const p_sync_state,
+                              std::uint8_t const* const p_src,
+                              std::size_t const p_count);
+
+    /// \brief Handles a text message received from the server.
+    ///
+    /// \param[in] p_message A parsed JSON message.
+    /// \param[in] p_now The current time in milliseconds.
+    void receive_text(Variant const& p_message, std::uint64_t const p_now);
+
+    /// \brief Saves the synchronization state to the file that it was
+    ///        restored from, if any.
+    ///
+    /// \param[in] p_now The current time in milliseconds.
+    Error save_sync_state(std::uint64_t const p_now);
+
+    std::uint32_t m_attempts;
+    std::uint64_t m_connect_msecs;
+    String m_domain_name;
+    std::atomic<std::uint64_t> m_heartbeat_msecs;
+    bool m_init_syncing;
+    Ref<JSON> m_json_parser;
+    int m_max_queued_packets;
+    String m_path;
+    String m_peer_id;
+    std::optional<std::uint64_t> m_ping_msecs;
+    String m_ping_text;
+    std::minstd_rand m_random;
+    std::uint64_t m_retry_msecs;
+    std::atomic<std::int64_t> m_round_trip_msecs;
+    Ref<WebSocketPeer> m_socket;
+    State m_state;
+    std::uint64_t m_sync_state_msecs;
+    String m_sync_state_path;
+    ResultPtr m_sync_state_result;
+    std::uint64_t m_traffic_msecs;
+};
+
+inline std::uint64_t AutomergeSyncSession::get_heartbeat_interval() const {
+    return m_heartbeat_msecs.load(std::memory_order_relaxed);
+}
+
+inline std::int64_t AutomergeSyncSession::get_round_trip_msecs() const {
+    return m_round_trip_msecs.load(std::memory_order_relaxed);
+}
+
+inline AutomergeSyncSession::State AutomergeSyncSession::get_state() const {
+    return m_state;
+}
+
+inline void AutomergeSyncSession::set_heartbeat_interval(std::uint64_t const p_msecs) {
+    m_heartbeat_msecs.store(p_msecs, std::memory_order_relaxed);
+}
+
+#endif  // REALITY_MERGE_AUTOMERGE_SYNC_SESSION_H
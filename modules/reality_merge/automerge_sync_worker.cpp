@@ -0,0 +1,116 @@
+/**************************************************************************/
+/* automerge_sync_worker.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <chrono>
+#include <utility>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// regional
+#include <core/error/error_macros.h>
+
+// local
+#include "automerge_sync_session.h"
+#include "automerge_sync_worker.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// \brief The period to sleep for when the server has nothing to send.
+constexpr auto IDLE_PERIOD = 1ms;
+
+}  // namespace
+
+AutomergeSyncWorker::AutomergeSyncWorker(std::unique_ptr<AutomergeSyncSession>&& p_session,
+                                         cavi::usdj_am::utils::Document&& p_document)
+    : m_advances{MAX_PENDING_ADVANCES},
+      m_document{std::move(p_document)},
+      m_running{true},
+      m_session{std::move(p_session)},
+      m_thread{&AutomergeSyncWorker::run, this} {}
+
+AutomergeSyncWorker::~AutomergeSyncWorker() {
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+std::int64_t AutomergeSyncWorker::get_round_trip_msecs() const {
+    return m_session->get_round_trip_msecs();
+}
+
+std::optional<AutomergeSyncWorker::Advance> AutomergeSyncWorker::pop_advance() {
+    return m_advances.pop();
+}
+
+void AutomergeSyncWorker::run() {
+    using ResultPtr = cavi::usdj_am::utils::Document::ResultPtr;
+
+    // The first incremental save of a fork encodes its whole history, which
+    // the original document already has, so only the ones after it count.
+    ResultPtr const baseline_result{AMsaveIncremental(m_document), AMresultFree};
+    bool pending = false;
+    while (m_running.load(std::memory_order_acquire)) {
+        auto const received = m_session->receive_changes(m_document);
+        pending = pending || received;
+        // Changes keep accumulating within the private document while the
+        // queue is full so none of them can be lost.
+        if (pending && !m_advances.is_full()) {
+            auto advance = take_advance();
+            if (advance)
+                pending = !m_advances.push(std::move(*advance));
+        }
+        if (!received) {
+            // Keep the connection, if there is one, alive.
+            m_session->heartbeat();
+            std::this_thread::sleep_for(IDLE_PERIOD);
+        }
+    }
+    m_session->close();
+}
+
+void AutomergeSyncWorker::set_heartbeat_interval(std::uint64_t const p_msecs) {
+    m_session->set_heartbeat_interval(p_msecs);
+}
+
+std::optional<AutomergeSyncWorker::Advance> AutomergeSyncWorker::take_advance() {
+    using ResultPtr = cavi::usdj_am::utils::Document::ResultPtr;
+
+    Advance advance{};
+    ResultPtr const save_result{AMsaveIncremental(m_document), AMresultFree};
+    AMbyteSpan changes = {0};
+    ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(save_result.get()), &changes), std::nullopt);
+    advance.changes.assign(changes.src, changes.src + changes.count);
+    return advance;
+}
@@ -0,0 +1,106 @@
+/**************************************************************************/
+/* automerge_sync_worker.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_AUTOMERGE_SYNC_WORKER_H
+#define REALITY_MERGE_AUTOMERGE_SYNC_WORKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// third-party
+#include <cavi/usdj_am/utils/document.hpp>
+
+// local
+#include "spsc_queue.h"
+
+class AutomergeSyncSession;
+
+/// \brief A thread that keeps a private copy of an Automerge document
+///        synchronized with a server's copy of it so that the thread that owns
+///        the original document only has to apply the resulting changes.
+class AutomergeSyncWorker {
+public:
+    /// \brief A notification that the worker's copy of the document advanced.
+    struct Advance {
+        /// \brief The changes received since the previous advance, as encoded
+        ///        by `AMsaveIncremental()`.
+        std::vector<std::uint8_t> changes;
+    };
+
+    /// \brief The count of advances that can be pending before the worker stops
+    ///        publishing and starts accumulating them instead.
+    static std::size_t const MAX_PENDING_ADVANCES = 64;
+
+    AutomergeSyncWorker() = delete;
+
+    /// \brief Starts a thread that owns the given session and document.
+    ///
+    /// \param[in] p_session A session for synchronizing \p p_document.
+    /// \param[in] p_document A private copy of an Automerge document.
+    AutomergeSyncWorker(std::unique_ptr<AutomergeSyncSession>&& p_session,
+                        cavi::usdj_am::utils::Document&& p_document);
+
+    AutomergeSyncWorker(AutomergeSyncWorker const&) = delete;
+
+    /// \brief Stops the thread and waits for it to finish.
+    ~AutomergeSyncWorker();
+
+    AutomergeSyncWorker& operator=(AutomergeSyncWorker const&) = delete;
+
+    /// \returns The smoothed round-trip time of the session's keepalive
+    ///          messages or `-1` if none of them has been answered yet.
+    std::int64_t get_round_trip_msecs() const;
+
+    /// \brief Takes the oldest unclaimed advance of the document.
+    ///
+    /// \returns An `Advance` or `std::nullopt`.
+    /// \note Only the thread that constructed the worker may call this.
+    std::optional<Advance> pop_advance();
+
+    /// \param[in] p_msecs A period of silence after which the session sends a
+    ///                    keepalive message.
+    void set_heartbeat_interval(std::uint64_t const p_msecs);
+
+private:
+    void run();
+
+    std::optional<Advance> take_advance();
+
+    SpscQueue<Advance> m_advances;
+    cavi::usdj_am::utils::Document m_document;
+    std::atomic<bool> m_running;
+    std::unique_ptr<AutomergeSyncSession> m_session;
+    std::thread m_thread;
+};
+
+#endif  // REALITY_MERGE_AUTOMERGE_SYNC_WORKER_H
@@ -28,26 +28,48 @@
 /**************************************************************************/
 
 // regional
+#include <core/config/engine.h>
+#include <core/config/project_settings.h>
 #include <core/object/class_db.h>
 #include <core/object/ref_counted.h>
 
 // local
 #include "automerge_resource.h"
+#include "automerge_sync_hub.h"
+#ifdef TOOLS_ENABLED
+#include "automerge_sync_server.h"
+#endif  // TOOLS_ENABLED
 #include "register_types.h"
 #include "usdj_mediator.h"
+#include "usdj_resource_cache.h"
 #include "usdj_static_body_3d.h"
 
+static AutomergeSyncHub* automerge_sync_hub = nullptr;
 static Ref<ResourceFormatLoaderAutomerge> resource_loader_automerge;
 static Ref<ResourceFormatSaverAutomerge> resource_saver_automerge;
+static UsdjResourceCache* usdj_resource_cache = nullptr;
 
 void initialize_reality_merge_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+    GLOBAL_DEF(AutomergeResource::INCREMENTAL_SAVE_SETTING, false);
+
     GDREGISTER_CLASS(AutomergeResource);
+    GDREGISTER_ABSTRACT_CLASS(AutomergeSyncHub);
+#ifdef TOOLS_ENABLED
+    GDREGISTER_CLASS(AutomergeSyncServer);
+#endif  // TOOLS_ENABLED
     GDREGISTER_CLASS(UsdjMediator);
+    GDREGISTER_ABSTRACT_CLASS(UsdjResourceCache);
     GDREGISTER_CLASS(UsdjStaticBody3D);
 
+    automerge_sync_hub = memnew(AutomergeSyncHub);
+    Engine::get_singleton()->add_singleton(Engine::Singleton("AutomergeSyncHub", AutomergeSyncHub::get_singleton()));
+
+    usdj_resource_cache = memnew(UsdjResourceCache);
+    Engine::get_singleton()->add_singleton(Engine::Singleton("UsdjResourceCache", UsdjResourceCache::get_singleton()));
+
     resource_loader_automerge.instantiate();
     ResourceLoader::add_resource_format_loader(resource_loader_automerge, true);
 
@@ -59,6 +81,14 @@ void uninitialize_reality_merge_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+    Engine::get_singleton()->remove_singleton("AutomergeSyncHub");
+    memdelete(automerge_sync_hub);
+    automerge_sync_hub = nullptr;
+
+    Engine::get_singleton()->remove_singleton("UsdjResourceCache");
+    memdelete(usdj_resource_cache);
+    usdj_resource_cache = nullptr;
+
     ResourceLoader::remove_resource_format_loader(resource_loader_automerge);
     resource_loader_automerge.unref();
 
@@ -0,0 +1,108 @@
+/**************************************************************************/
+/* spsc_queue.h                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_SPSC_QUEUE_H
+#define REALITY_MERGE_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/// \brief A bounded, lock-free queue for handing values from exactly one
+///        producer thread to exactly one consumer thread.
+///
+/// \tparam T The type of a queued value.
+template <typename T>
+class SpscQueue {
+public:
+    SpscQueue() = delete;
+
+    /// \param[in] p_capacity The maximum count of values that can be queued.
+    /// \pre \p p_capacity `> 0`
+    explicit SpscQueue(std::size_t const p_capacity);
+
+    SpscQueue(SpscQueue const&) = delete;
+
+    SpscQueue& operator=(SpscQueue const&) = delete;
+
+    /// \brief Dequeues the oldest value.
+    ///
+    /// \returns The value or `std::nullopt` if the queue is empty.
+    /// \note Only the consumer thread may call this.
+    std::optional<T> pop();
+
+    /// \brief Enqueues a value.
+    ///
+    /// \param[in] p_value A value.
+    /// \returns `false` if the queue is full.
+    /// \note Only the producer thread may call this.
+    bool push(T&& p_value);
+
+    /// \note Only the producer thread may rely upon a `false` result.
+    bool is_full() const;
+
+private:
+    std::vector<std::optional<T>> m_slots;
+    std::atomic<std::size_t> m_head;
+    std::atomic<std::size_t> m_tail;
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(std::size_t const p_capacity) : m_slots(p_capacity + 1), m_head{0}, m_tail{0} {}
+
+template <typename T>
+std::optional<T> SpscQueue<T>::pop() {
+    auto const head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+        return std::nullopt;
+    std::optional<T> value{std::move(m_slots[head])};
+    m_slots[head].reset();
+    m_head.store((head + 1) % m_slots.size(), std::memory_order_release);
+    return value;
+}
+
+template <typename T>
+bool SpscQueue<T>::push(T&& p_value) {
+    auto const tail = m_tail.load(std::memory_order_relaxed);
+    auto const next = (tail + 1) % m_slots.size();
+    if (next == m_head.load(std::memory_order_acquire))
+        return false;
+    m_slots[tail].emplace(std::move(p_value));
+    m_tail.store(next, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::is_full() const {
+    return (m_tail.load(std::memory_order_relaxed) + 1) % m_slots.size() == m_head.load(std::memory_order_acquire);
+}
+
+#endif  // REALITY_MERGE_SPSC_QUEUE_H
@@ -31,6 +31,7 @@
 #define CAVI_USDJ_AM_ARRAY_ITERATOR_HPP
 
 #include <array>
+#include <cstddef>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -43,6 +44,11 @@ extern "C" {
 
 namespace cavi {
 namespace usdj_am {
+namespace utils {
+
+class ResultArena;
+
+}  // namespace utils
 
 template <typename T>
 class ArrayInputIterator;
@@ -62,6 +68,7 @@ template <typename T>
 class ArrayInputIterator {
 public:
     using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
     using value_type = T;
     using pointer = T*;
     using reference = T&;
@@ -72,12 +79,18 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param list_object[in] A pointer to a borrowed Automerge list object.
+    /// \param index[in] The position of the first element to be iterated over.
+    /// \param chunk_size[in] The count of elements to fetch at once; elements
+    ///                       are fetched one at a time when it's `<= 1`.
     /// \pre \p document `!= nullptr`
     /// \pre \p list_object `!= nullptr`
     /// \pre `AMitemValType(` \p list_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p list_object `)) == AM_OBJ_TYPE_LIST`
     /// \throws std::invalid_argument
-    ArrayInputIterator(AMdoc const* const document, AMitem const* const list_object);
+    ArrayInputIterator(AMdoc const* const document,
+                       AMitem const* const list_object,
+                       std::size_t const index = 0,
+                       std::size_t const chunk_size = 0);
 
     ArrayInputIterator(ArrayInputIterator const&) = default;
 
@@ -92,10 +105,27 @@ public:
     T operator*();
 
 private:
-    enum Result { BEGIN__, ITEMS = BEGIN__, OBJ_ID, END__, SIZE__ = END__ - BEGIN__ };
+    enum Result { BEGIN__, CHUNK = BEGIN__, OBJ_ID, END__, SIZE__ = END__ - BEGIN__ };
+
+    /// \brief Gets the element at the current position from the prefetched
+    ///        chunk, fetching the chunk that contains it first if needed.
+    ///
+    /// \return A pointer to a borrowed Automerge item or `nullptr`.
+    AMitem const* get_chunk_item();
+
+    /// \brief Indicates whether the current position is past the last element.
+    bool is_end() const;
 
     AMdoc const* const m_document;
-    std::optional<AMitems> m_items;
+    /// The arena that the iterator was created within, if any, which owns the
+    /// prefetched chunks.
+    utils::ResultArena* const m_arena;
+    std::size_t m_index;
+    std::size_t m_size;
+    std::size_t const m_chunk_size;
+    /// The position of the first element within the prefetched chunk.
+    std::size_t m_chunk_index;
+    std::optional<AMitems> m_chunk;
     std::array<ResultPtr, SIZE__> m_results;
 
     friend bool operator==<T>(ArrayInputIterator<T> const& lhs, ArrayInputIterator<T> const& rhs);
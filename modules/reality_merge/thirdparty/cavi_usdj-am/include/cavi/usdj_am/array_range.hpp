@@ -30,6 +30,8 @@
 #ifndef CAVI_USDJ_AM_ARRAY_RANGE_HPP
 #define CAVI_USDJ_AM_ARRAY_RANGE_HPP
 
+#include <cstddef>
+
 // local
 #include "array_iterator.hpp"
 
@@ -48,6 +50,9 @@ class ArrayInputRange {
 public:
     using value_type = typename ArrayInputIterator<T>::value_type;
 
+    /// The count of elements that an iterator fetches at once by default.
+    static constexpr const std::size_t DEFAULT_CHUNK_SIZE = 16;
+
     ArrayInputRange() = delete;
 
     /// \param document[in] A pointer to a borrowed Automerge document.
@@ -67,8 +72,25 @@ public:
 
     ArrayInputIterator<T> end() const;
 
+    /// \brief Gets the element at the given position without fetching any of
+    ///        the others.
+    ///
+    /// \param index[in] A position within the array.
+    /// \pre \p index `< size()`
+    /// \throws std::out_of_range
+    T operator[](std::size_t const index) const;
+
     std::size_t size() const;
 
+    /// \brief Gets the count of elements that an iterator fetches at once.
+    std::size_t get_chunk_size() const;
+
+    /// \brief Sets the count of elements that an iterator fetches at once.
+    ///
+    /// \param chunk_size[in] A count of elements; they're fetched one at a time
+    ///                       when it's `<= 1`.
+    void set_chunk_size(std::size_t const chunk_size);
+
     AMdoc const* get_document() const;
 
     AMobjId const* get_object_id() const;
@@ -76,6 +98,7 @@ public:
 private:
     AMdoc const* const m_document;
     typename ArrayInputIterator<T>::ResultPtr m_result;
+    std::size_t m_chunk_size;
 };
 
 }  // namespace usdj_am
@@ -33,6 +33,7 @@
 #include <cstdint>
 #include <iosfwd>
 #include <optional>
+#include <string_view>
 
 // local
 #include "assignment_keyword.hpp"
@@ -125,6 +126,13 @@ constexpr AssignmentType Assignment::get_type() const {
     return AssignmentType::ASSIGNMENT;
 }
 
+/// \brief Extracts an `AssignmentType` enum tag from a string view.
+///
+/// \param[in] view A UTF-8 string view.
+/// \returns The `AssignmentType` enum tag whose serialized form is \p view or
+///          `std::nullopt`.
+std::optional<AssignmentType> extract_AssignmentType(std::string_view const& view);
+
 std::istream& operator>>(std::istream& is, AssignmentType& out);
 
 std::ostream& operator<<(std::ostream& os, AssignmentType const& in);
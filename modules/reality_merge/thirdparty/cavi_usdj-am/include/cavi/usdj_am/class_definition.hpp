@@ -30,6 +30,7 @@
 #ifndef CAVI_USDJ_AM_CLASS_DEFINITION_HPP
 #define CAVI_USDJ_AM_CLASS_DEFINITION_HPP
 
+#include <memory>
 #include <optional>
 
 // local
@@ -62,13 +63,17 @@ public:
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param type[in] The result of getting the "type" property of
+    ///                 \p map_object if it was already gotten.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `)) == 5`
     /// \throws std::invalid_argument
-    ClassDefinition(AMdoc const* const document, AMitem const* const map_object);
+    ClassDefinition(AMdoc const* const document,
+                    AMitem const* const map_object,
+                    std::shared_ptr<AMresult> const& type = nullptr);
 
     ClassDefinition(ClassDefinition const&) = delete;
 
@@ -32,6 +32,8 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <string_view>
 
 // export enum USDA_DeclarationKeyword {
 //     Varying = 'varying',
@@ -61,6 +63,13 @@ enum class DeclarationKeyword : std::uint8_t {
     SIZE__ = END__ - BEGIN__
 };
 
+/// \brief Extracts a `DeclarationKeyword` enum tag from a string view.
+///
+/// \param[in] view A UTF-8 string view.
+/// \returns The `DeclarationKeyword` enum tag whose serialized form is \p view or
+///          `std::nullopt`.
+std::optional<DeclarationKeyword> extract_DeclarationKeyword(std::string_view const& view);
+
 std::istream& operator>>(std::istream& is, DeclarationKeyword& out);
 
 std::ostream& operator<<(std::ostream& os, DeclarationKeyword const& in);
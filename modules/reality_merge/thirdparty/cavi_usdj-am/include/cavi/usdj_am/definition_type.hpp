@@ -32,6 +32,8 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <optional>
+#include <string_view>
 
 // export enum USDA_DefinitionType {
 //     Def = 'def',
@@ -45,6 +47,13 @@ namespace usdj_am {
 ///        string within an Automerge document.
 enum class DefinitionType : std::uint8_t { BEGIN__ = 1, DEF = BEGIN__, OVER, END__, SIZE__ = END__ - BEGIN__ };
 
+/// \brief Extracts a `DefinitionType` enum tag from a string view.
+///
+/// \param[in] view A UTF-8 string view.
+/// \returns The `DefinitionType` enum tag whose serialized form is \p view or
+///          `std::nullopt`.
+std::optional<DefinitionType> extract_DefinitionType(std::string_view const& view);
+
 std::istream& operator>>(std::istream& is, DefinitionType& out);
 
 std::ostream& operator<<(std::ostream& os, DefinitionType const& in);
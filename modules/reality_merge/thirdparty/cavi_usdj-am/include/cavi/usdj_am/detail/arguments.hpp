@@ -1,5 +1,5 @@
 /**************************************************************************/
-/* usdj_box_size_extractor.h                                              */
+/* detail/arguments.hpp                                                   */
 /**************************************************************************/
 /*                         This file is part of:                          */
 /*                             RealityMerge                               */
@@ -27,54 +27,71 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#ifndef REALITY_MERGE_USDJ_BOX_SIZE_EXTRACTOR_H
-#define REALITY_MERGE_USDJ_BOX_SIZE_EXTRACTOR_H
+#ifndef CAVI_USDJ_AM_DETAIL_ARGUMENTS_HPP
+#define CAVI_USDJ_AM_DETAIL_ARGUMENTS_HPP
 
 #include <memory>
-#include <optional>
+#include <sstream>
+#include <string>
 
-// third-party
-#include <cavi/usdj_am/visitor.hpp>
+namespace cavi {
+namespace usdj_am {
+namespace detail {
 
-struct Vector3;
-
-/// \brief An extractor of a box's size value embedded within a "USDA_Definition"
-///        node.
-class UsdjBoxSizeExtractor : public cavi::usdj_am::Visitor {
+/// \brief A description of the invalid arguments of a call whose stream is
+///        only constructed once something is written into it so that a
+///        successful validation neither allocates nor formats anything.
+class Arguments {
 public:
-    UsdjBoxSizeExtractor() = delete;
-
-    UsdjBoxSizeExtractor(cavi::usdj_am::Definition const& p_definition);
-
-    UsdjBoxSizeExtractor(UsdjBoxSizeExtractor const&) = delete;
-
-    UsdjBoxSizeExtractor(UsdjBoxSizeExtractor&&) = default;
+    Arguments() = default;
 
-    ~UsdjBoxSizeExtractor();
+    Arguments(Arguments const&) = delete;
 
-    UsdjBoxSizeExtractor& operator=(UsdjBoxSizeExtractor const&) = delete;
+    Arguments& operator=(Arguments const&) = delete;
 
-    UsdjBoxSizeExtractor& operator=(UsdjBoxSizeExtractor&&) = default;
+    /// \returns `true` if anything was written.
+    explicit operator bool() const;
 
-    std::optional<Vector3> operator()();
+    /// \brief Discards anything that was written.
+    void clear();
 
-    void visit(cavi::usdj_am::Assignment const& assignment) override;
+    /// \brief Writes a value into the stream.
+    ///
+    /// \tparam T The type of value to write.
+    /// \param[in] value A value that can be written into a `std::ostream`.
+    template <typename T>
+    Arguments& operator<<(T const& value);
 
-    void visit(cavi::usdj_am::Declaration const& declaration) override;
+    /// \returns The text that was written.
+    std::string str() const;
 
-    void visit(cavi::usdj_am::Definition const& definition) override;
+private:
+    std::unique_ptr<std::ostringstream> m_stream;
+};
 
-    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
+inline Arguments::operator bool() const {
+    return static_cast<bool>(m_stream);
+}
 
-    void visit(cavi::usdj_am::Descriptor const& descriptor) override;
+inline void Arguments::clear() {
+    m_stream.reset();
+}
 
-    void visit(cavi::usdj_am::ExternalReference const& external_reference) override;
+template <typename T>
+Arguments& Arguments::operator<<(T const& value) {
+    if (!m_stream) {
+        m_stream = std::make_unique<std::ostringstream>();
+    }
+    *m_stream << value;
+    return *this;
+}
 
-    void visit(cavi::usdj_am::ReferenceFile const& reference_file) override;
+inline std::string Arguments::str() const {
+    return (m_stream) ? m_stream->str() : std::string{};
+}
 
-private:
-    cavi::usdj_am::Definition const& m_definition;
-    std::optional<Vector3> m_size;
-};
+}  // namespace detail
+}  // namespace usdj_am
+}  // namespace cavi
 
-#endif  // REALITY_MERGE_USDJ_BOX_SIZE_EXTRACTOR_H
+#endif  // CAVI_USDJ_AM_DETAIL_ARGUMENTS_HPP
@@ -0,0 +1,146 @@
+/**************************************************************************/
+/* detail/map_type.hpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef CAVI_USDJ_AM_DETAIL_MAP_TYPE_HPP
+#define CAVI_USDJ_AM_DETAIL_MAP_TYPE_HPP
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// local
+#include "detail/arguments.hpp"
+#include "string_.hpp"
+#include "utils/bytes.hpp"
+#include "utils/result_arena.hpp"
+
+namespace cavi {
+namespace usdj_am {
+namespace detail {
+
+/// \brief Extracts a tag from the "type" property of a map object without
+///        throwing so that the alternative of a variant that it names can be
+///        constructed without trying the others first.
+///
+/// \tparam ExtractT The type of a callable that extracts an optional tag from
+///                  a UTF-8 string view.
+/// \param[in] document A pointer to a borrowed Automerge document.
+/// \param[in] map_object A pointer to a borrowed Automerge map object.
+/// \param[in] extract A callable that extracts an optional tag from a UTF-8
+///                    string view.
+/// \param[in,out] type The result of getting the "type" property, which is
+///                     only gotten when it's empty so that the node that's
+///                     constructed can reuse it.
+/// \returns The tag or `std::nullopt` if the "type" property isn't a string
+///          or text object that \p extract recognizes.
+template <typename ExtractT>
+auto extract_map_type(AMdoc const* const document,
+                      AMitem const* const map_object,
+                      ExtractT&& extract,
+                      std::shared_ptr<AMresult>& type) -> decltype(extract(std::string_view{})) {
+    if (document && map_object && AMitemValType(map_object) == AM_VAL_TYPE_OBJ_TYPE) {
+        if (!type) {
+            type = utils::ResultArena::adopt(AMmapGet(document, AMitemObjId(map_object), AMstr("type"), nullptr));
+        }
+        AMitem const* const item = (type) ? AMresultItem(type.get()) : nullptr;
+        AMbyteSpan str;
+        if (item && AMitemToStr(item, &str)) {
+            return extract(utils::from_bytes(str));
+        } else if (item && AMitemValType(item) == AM_VAL_TYPE_OBJ_TYPE &&
+                   AMobjObjType(document, AMitemObjId(item)) == AM_OBJ_TYPE_TEXT) {
+            return extract(String{document, item});
+        }
+    }
+    return std::nullopt;
+}
+
+/// \brief Extracts a tag from the "type" property of a map object without
+///        throwing.
+///
+/// \tparam ExtractT The type of a callable that extracts an optional tag from
+///                  a UTF-8 string view.
+/// \param[in] document A pointer to a borrowed Automerge document.
+/// \param[in] map_object A pointer to a borrowed Automerge map object.
+/// \param[in] extract A callable that extracts an optional tag from a UTF-8
+///                    string view.
+/// \returns The tag or `std::nullopt` if the "type" property isn't a string
+///          or text object that \p extract recognizes.
+template <typename ExtractT>
+auto extract_map_type(AMdoc const* const document, AMitem const* const map_object, ExtractT&& extract)
+    -> decltype(extract(std::string_view{})) {
+    std::shared_ptr<AMresult> type;
+    return extract_map_type(document, map_object, std::forward<ExtractT>(extract), type);
+}
+
+/// \brief Describes why the "type" property of a map object names none of a
+///        variant's alternatives without trying to construct any of them.
+///
+/// \param[in] document A pointer to a borrowed Automerge document.
+/// \param[in] map_object A pointer to a borrowed Automerge map object.
+/// \param[in] type The result of getting the "type" property or `nullptr`.
+/// \param[in,out] args The description of the invalid arguments.
+inline void describe_map_type(AMdoc const* const document,
+                              AMitem const* const map_object,
+                              AMresult* const type,
+                              Arguments& args) {
+    if (!document) {
+        args << "document == nullptr, ...";
+    } else if (!map_object) {
+        args << "..., map_object == nullptr";
+    } else if (AMitemValType(map_object) != AM_VAL_TYPE_OBJ_TYPE) {
+        args << "..., AMitemValType(map_object) != AM_VAL_TYPE_OBJ_TYPE";
+    } else {
+        AMitem const* const item = (type) ? AMresultItem(type) : nullptr;
+        AMbyteSpan str;
+        args << "AMmapGet(document, AMitemObjId(map_object), AMstr(\"type\"), nullptr) == ";
+        if (!item) {
+            args << "nullptr";
+        } else if (AMitemToStr(item, &str)) {
+            args << "\"" << utils::from_bytes(str) << "\"";
+        } else if (AMitemValType(item) == AM_VAL_TYPE_OBJ_TYPE &&
+                   AMobjObjType(document, AMitemObjId(item)) == AM_OBJ_TYPE_TEXT) {
+            args << "\"" << String{document, item} << "\"";
+        } else {
+            args << "<not a string>";
+        }
+    }
+}
+
+}  // namespace detail
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_DETAIL_MAP_TYPE_HPP
@@ -30,8 +30,10 @@
 #ifndef CAVI_USDJ_AM_NODE_HPP
 #define CAVI_USDJ_AM_NODE_HPP
 
+#include <array>
 #include <cassert>
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <sstream>
@@ -48,6 +50,7 @@ extern "C" {
 // local
 #include "string_.hpp"
 #include "utils/bytes.hpp"
+#include "utils/result_arena.hpp"
 
 namespace cavi {
 namespace usdj_am {
@@ -64,6 +67,50 @@ using Typename = String;
 ///        Automerge document.
 class Node {
 public:
+    /// \brief A compile-time descriptor of a property of a node's map object.
+    struct Property {
+        /// \brief The index of the property's result within the node.
+        std::size_t slot;
+        /// \brief The property's key within the node's map object.
+        std::string_view key;
+    };
+
+    /// \brief The most properties within any type of node's map object.
+    static constexpr std::size_t MAX_PROPERTIES = 6;
+
+    /// \brief A span of the descriptors of all of the properties within a
+    ///        type of node's map object.
+    class Properties {
+    public:
+        constexpr Properties() : m_begin{nullptr}, m_end{nullptr} {}
+
+        template <std::size_t N>
+        constexpr Properties(std::array<Property, N> const& properties)
+            : m_begin{properties.data()}, m_end{properties.data() + N} {
+            static_assert(N <= MAX_PROPERTIES, "Too many properties for a node's slots.");
+        }
+
+        constexpr Property const* begin() const {
+            return m_begin;
+        }
+
+        constexpr Property const* end() const {
+            return m_end;
+        }
+
+        constexpr std::size_t size() const {
+            return static_cast<std::size_t>(m_end - m_begin);
+        }
+
+    private:
+        Property const* m_begin;
+        Property const* m_end;
+    };
+
+    /// \returns The count of calls made into Automerge by all nodes to fetch
+    ///          their properties.
+    static std::uint64_t get_fetch_count();
+
     virtual ~Node();
 
     Node(Node const&) = delete;
@@ -84,25 +131,34 @@ public:
 
     virtual AMobjId const* get_object_id() const;
 
+    /// \brief Fetches all of the properties at once so that reading them
+    ///        needs no further calls into Automerge.
+    ///
+    /// \note The properties then reflect the document as it was when they
+    ///       were materialized until they're materialized again.
+    void materialize() const;
+
 protected:
     using ResultPtr = std::shared_ptr<AMresult>;
 
-    inline Node() : m_document{nullptr} {};
+    inline Node() : m_document{nullptr}, m_arena{nullptr}, m_map_object{}, m_properties{}, m_results{}, m_items{} {};
 
     /// \param document[in] A pointer to a borrowed Automerge document.
+    /// \param properties[in] The descriptors of all of the node's properties.
     /// \pre \p document `!= nullptr`
-    Node(AMdoc const* const document);
+    Node(AMdoc const* const document, Properties const properties);
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
-    /// \param map_size[in] The expected count of items in \p map_object.
+    /// \param properties[in] The descriptors of all of the items expected in
+    ///                       \p map_object.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
-    /// \pre \p map_size `> 0`
+    /// \pre \p properties `.size() > 0`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
-    /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `), nullptr) ==` \p map_size
-    Node(AMdoc const* const document, AMitem const* const map_object, int const map_size);
+    /// \pre `AMobjSize(` \p document `, AMitemObjId(` \p map_object `), nullptr) ==` \p properties `.size()`
+    Node(AMdoc const* const document, AMitem const* const map_object, Properties const properties);
 
     Node(Node&&) = default;
 
@@ -112,61 +168,116 @@ protected:
     ///        tag value.
     ///
     /// \tparam EnumT A type of enum.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param property[in] A property descriptor.
     /// \throws std::invalid_argument
     template <typename EnumT>
-    void check_enum_property(std::string const& key, EnumT const tag) const;
+    void check_enum_property(Property const& property, EnumT const tag) const;
 
     /// \brief Checks that the string property under a given key matches the
     ///        given string value.
     ///
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param property[in] A property descriptor.
     /// \param value[in] A pointer to a null-terminated byte string.
     /// \throws std::invalid_argument
-    void check_string_property(std::string const& key, std::string const& value) const;
+    void check_string_property(Property const& property, std::string const& value) const;
+
+    /// \brief Finds the enum property under a given key without throwing.
+    ///
+    /// \tparam EnumT A type of enum.
+    /// \param property[in] A property descriptor.
+    /// \returns The \p EnumT tag or `std::nullopt` if the property isn't the
+    ///          serialized form of one.
+    template <typename EnumT>
+    std::optional<EnumT> find_enum_property(Property const& property) const;
+
+    /// \brief Finds the property under a given key without throwing.
+    ///
+    /// \param property[in] A property descriptor.
+    /// \returns A pointer to the borrowed item storing the property, which
+    ///          may be void, or `nullptr` if it couldn't be gotten.
+    /// \note The property is fetched at most once until it's released, which
+    ///       doesn't happen within an arena.
+    AMitem const* find_property(Property const& property) const;
 
     /// \brief Gets the string property under a given key.
     ///
     /// \tparam InputRangeT A type satisfying the `std::ranges::array_range`
     ///         concept.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param property[in] A property descriptor.
     template <typename InputRangeT>
-    InputRangeT get_array_property(std::string const& key) const;
+    InputRangeT get_array_property(Property const& property) const;
 
     /// \brief Gets the enum property under a given key.
     ///
     /// \tparam EnumT A type of enum.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param property[in] A property descriptor.
     /// \throws std::invalid_argument
     template <typename EnumT>
-    EnumT get_enum_property(std::string const& key) const;
+    EnumT get_enum_property(Property const& property) const;
 
     /// \brief Gets the nullable enum property under a given key.
     ///
     /// \tparam EnumT A type of enum.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param property[in] A property descriptor.
     /// \throws std::invalid_argument
     template <typename EnumT>
-    std::optional<EnumT> get_nullable_enum_property(std::string const& key) const;
+    std::optional<EnumT> get_nullable_enum_property(Property const& property) const;
 
     /// \brief Gets the nullable object property under a given key.
     ///
     /// \tparam ObjectT A type of object.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param property[in] A property descriptor.
     /// \throws std::invalid_argument
     template <typename ObjectT>
-    std::optional<ObjectT> get_nullable_object_property(std::string const& key) const;
+    std::optional<ObjectT> get_nullable_object_property(Property const& property) const;
 
     /// \brief Gets the object property under a given key.
     ///
     /// \tparam ObjectT A type of object.
-    /// \param key[in] A pointer to a null-terminated byte string.
+    /// \param property[in] A property descriptor.
     /// \throws std::invalid_argument
     template <typename ObjectT>
-    ObjectT get_object_property(std::string const& key) const;
+    ObjectT get_object_property(Property const& property) const;
 
-    AMdoc const* const m_document;
-    mutable std::map<std::string, ResultPtr> m_results;
+    /// \brief Stores the result of a property that was already gotten in its
+    ///        slot so that it isn't fetched again.
+    ///
+    /// \param property[in] A property descriptor.
+    /// \param result[in] The result of getting the property or `nullptr`.
+    void reuse_property(Property const& property, ResultPtr const& result) const;
+
+    AMdoc const* m_document;
+    /// \brief The arena that the node was created within, if any, which owns
+    ///        the results of its properties.
+    utils::ResultArena* m_arena;
+    /// \brief The result storing the node's object ID.
+    ResultPtr m_map_object;
+    Properties m_properties;
+    /// \brief The results of the properties by slot.
+    mutable std::array<ResultPtr, MAX_PROPERTIES> m_results;
+    /// \brief The fetched or materialized items of the properties by slot.
+    mutable std::array<AMitem const*, MAX_PROPERTIES> m_items;
+
+private:
+    /// \brief Releases the result in a property's slot because it's no
+    ///        longer needed, unless the node's arena owns it.
+    ///
+    /// \param property[in] A property descriptor.
+    void release_property(Property const& property) const;
+
+    /// \brief Gets the property under a given key and stores it in its slot.
+    ///
+    /// \param property[in] A property descriptor.
+    /// \returns The result in the property's slot.
+    ResultPtr const& store_property(Property const& property) const;
+
+    /// \brief Constructs an object from a property's item.
+    ///
+    /// \tparam ObjectT A type of object.
+    /// \param item[in] A pointer to a borrowed Automerge item or `nullptr`.
+    /// \throws std::invalid_argument
+    template <typename ObjectT>
+    ObjectT to_object(AMitem const* const item) const;
 };
 
 inline AMdoc const* Node::get_document() const {
@@ -1,5 +1,5 @@
 /**************************************************************************/
-/* usdj_transform_3d_extractor.h                                          */
+/* scene_change.hpp                                                       */
 /**************************************************************************/
 /*                         This file is part of:                          */
 /*                             RealityMerge                               */
@@ -27,48 +27,50 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#ifndef REALITY_MERGE_USDJ_TRANSFORM_3D_EXTRACTOR_H
-#define REALITY_MERGE_USDJ_TRANSFORM_3D_EXTRACTOR_H
+#ifndef CAVI_USDJ_AM_SCENE_CHANGE_HPP
+#define CAVI_USDJ_AM_SCENE_CHANGE_HPP
 
-#include <memory>
+#include <cstdint>
+#include <iosfwd>
 #include <optional>
+#include <string>
+
+struct AMobjId;
+
+namespace cavi {
+namespace usdj_am {
+
+/// \brief An enum representing a kind of change to a syntax tree that was
+///        parsed out of a USDA document, encoded as JSON and stored within an
+///        Automerge document.
+enum class SceneChangeType : std::uint8_t {
+    BEGIN__ = 1,
+    DECLARATION_CHANGED = BEGIN__,
+    DEFINITION_CHANGED,
+    DESCRIPTOR_CHANGED,
+    PRIM_ADDED,
+    PRIM_REMOVED,
+    XFORM_OP_ORDER_CHANGED,
+    END__,
+    SIZE__ = END__ - BEGIN__
+};
 
-// third-party
-#include <cavi/usdj_am/visitor.hpp>
-
-struct Transform3D;
-
-/// \brief An extractor of a transform value embedded within a "USDA_Definition"
-///        node.
-class UsdjTransform3dExtractor : public cavi::usdj_am::Visitor {
-public:
-    UsdjTransform3dExtractor() = delete;
-
-    UsdjTransform3dExtractor(cavi::usdj_am::Definition const& p_definition);
-
-    UsdjTransform3dExtractor(UsdjTransform3dExtractor const&) = delete;
-
-    UsdjTransform3dExtractor(UsdjTransform3dExtractor&&) = default;
-
-    ~UsdjTransform3dExtractor();
-
-    UsdjTransform3dExtractor& operator=(UsdjTransform3dExtractor const&) = delete;
-
-    UsdjTransform3dExtractor& operator=(UsdjTransform3dExtractor&&) = default;
-
-    std::optional<Transform3D> operator()();
-
-    void visit(cavi::usdj_am::Definition const& definition) override;
-
-    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
-
-    void visit(cavi::usdj_am::Declaration const& declaration) override;
-
-private:
-    struct Data;
-
-    cavi::usdj_am::Definition const& m_definition;
-    std::unique_ptr<Data> m_data;
+std::ostream& operator<<(std::ostream& os, SceneChangeType const& in);
+
+/// \brief A struct representing a change to a "USDA_Definition" or "USDA_File"
+///        node within an Automerge document.
+struct SceneChange {
+    /// \brief The kind of change.
+    SceneChangeType type;
+    /// \brief A pointer to the ID of the "USDA_Definition" or "USDA_File"
+    ///        node that owns the change.
+    AMobjId const* object_id;
+    /// \brief The `.reference` property of the changed "USDA_Declaration"
+    ///        node, if any.
+    std::optional<std::string> identifier;
 };
 
-#endif  // REALITY_MERGE_USDJ_TRANSFORM_3D_EXTRACTOR_H
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_SCENE_CHANGE_HPP
@@ -0,0 +1,132 @@
+/**************************************************************************/
+/* scene_changes.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef CAVI_USDJ_AM_SCENE_CHANGES_HPP
+#define CAVI_USDJ_AM_SCENE_CHANGES_HPP
+
+#include <cstddef>
+#include <vector>
+
+// local
+#include "scene_change.hpp"
+#include "scene_index.hpp"
+
+struct AMitems;
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+class Operations;
+
+}  // namespace utils
+
+/// \brief Classifies the operations within the changes that were made to an
+///        Automerge document between two versions of it by the parts of a
+///        syntax tree that was parsed out of a USDA document and encoded as
+///        JSON within it that they apply to.
+///
+/// \note Consecutive identical changes are merged into one.
+/// \note Only the objects that the operations apply to are read, so the cost
+///       is proportional to the size of the changes rather than to the size
+///       of the tree.
+class SceneChanges {
+public:
+    using Changes = std::vector<SceneChange>;
+    using const_iterator = Changes::const_iterator;
+
+    SceneChanges() = delete;
+
+    /// \param index[in] An index of the tree in the earlier version of the
+    ///                  document that's updated with the objects that the
+    ///                  operations make and that must outlive this object.
+    /// \param operations[in] The operations of the changes that were made to
+    ///                       the document between the two versions.
+    /// \param after_heads[in] A pointer to the change hashes of the later
+    ///                        version.
+    SceneChanges(SceneIndex& index, utils::Operations const& operations, AMitems const* const after_heads);
+
+    SceneChanges(SceneChanges const&) = delete;
+
+    SceneChanges(SceneChanges&&) = default;
+
+    ~SceneChanges();
+
+    SceneChanges& operator=(SceneChanges const&) = delete;
+
+    SceneChanges& operator=(SceneChanges&&) = default;
+
+    const_iterator begin() const;
+
+    bool empty() const;
+
+    const_iterator end() const;
+
+    std::size_t size() const;
+
+private:
+    /// \brief Appends the change that a statement which was added, removed or
+    ///        altered amounts to.
+    ///
+    /// \param owner_id[in] A pointer to the ID of the "USDA_Definition" or
+    ///                     "USDA_File" node that owns the statement.
+    /// \param statement[in] A pointer to the statement or `nullptr` if it's
+    ///                      unknown.
+    /// \param definition_type[in] The kind of change for a "USDA_Definition"
+    ///                            statement.
+    void push_statement(AMobjId const* const owner_id,
+                        SceneIndex::Statement const* const statement,
+                        SceneChangeType const definition_type);
+
+    /// \brief Appends a change unless it's identical to the last one.
+    void push_back(SceneChange&& change);
+
+    Changes m_changes;
+};
+
+inline SceneChanges::const_iterator SceneChanges::begin() const {
+    return m_changes.begin();
+}
+
+inline bool SceneChanges::empty() const {
+    return m_changes.empty();
+}
+
+inline SceneChanges::const_iterator SceneChanges::end() const {
+    return m_changes.end();
+}
+
+inline std::size_t SceneChanges::size() const {
+    return m_changes.size();
+}
+
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_SCENE_CHANGES_HPP
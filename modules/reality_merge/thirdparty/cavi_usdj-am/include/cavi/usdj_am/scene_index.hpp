@@ -0,0 +1,214 @@
+/**************************************************************************/
+/* scene_index.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef CAVI_USDJ_AM_SCENE_INDEX_HPP
+#define CAVI_USDJ_AM_SCENE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// local
+#include "statement_type.hpp"
+
+struct AMdoc;
+struct AMitem;
+struct AMitems;
+struct AMobjId;
+struct AMresult;
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+class Operations;
+
+}  // namespace utils
+
+/// \brief An index of the Automerge objects within a syntax tree that was
+///        parsed out of a USDA document and encoded as JSON, by the
+///        "USDA_Definition" or "USDA_File" node that owns each of them.
+///
+/// \note Building an index reads every object within the tree once so it's
+///       meant to be rebuilt only when the tree is traversed in full anyway
+///       and to be kept up to date by `SceneChanges` in between.
+class SceneIndex {
+public:
+    /// \brief The part that an object plays within the node that owns it.
+    enum class Role : std::uint8_t {
+        /// \brief The node's own map object.
+        DEFINITION,
+        /// \brief The node's `.descriptor` property or an object within it.
+        DESCRIPTOR,
+        /// \brief The node's `.statements` property.
+        STATEMENTS,
+        /// \brief A statement within the node's `.statements` property that
+        ///        isn't a "USDA_Definition" node of its own.
+        STATEMENT,
+        /// \brief A property of such a statement or an object within it.
+        STATEMENT_PROPERTY,
+        /// \brief Any other property of the node or an object within it.
+        PROPERTY,
+    };
+
+    /// \brief What's known about a statement.
+    struct Statement {
+        /// \brief The statement's `.type` property, if known.
+        std::optional<StatementType> type;
+        /// \brief The `.reference` property of a "USDA_Declaration" node.
+        std::optional<std::string> identifier;
+    };
+
+    struct Entry {
+        Role role;
+        /// \brief A pointer to the ID of the node that owns the object.
+        AMobjId const* owner;
+        /// \brief A pointer to the statement that the object is or is within,
+        ///        if any.
+        Statement const* statement;
+    };
+
+    SceneIndex() = delete;
+
+    /// \param[in] document A pointer to a borrowed Automerge document.
+    /// \param[in] file_item A pointer to a borrowed item holding a
+    ///                      "USDA_File" map object within \p document.
+    /// \pre \p document `!= nullptr`
+    /// \pre \p file_item `!= nullptr`
+    /// \throws std::invalid_argument
+    SceneIndex(AMdoc* const document, AMitem const* const file_item);
+
+    SceneIndex(SceneIndex const&) = delete;
+
+    SceneIndex(SceneIndex&&) = default;
+
+    ~SceneIndex();
+
+    SceneIndex& operator=(SceneIndex const&) = delete;
+
+    SceneIndex& operator=(SceneIndex&&) = default;
+
+    /// \brief Finds an object within the tree.
+    ///
+    /// \param[in] key An object ID encoded by `utils::Operations::make_key()`.
+    /// \returns A pointer to the object's entry or `nullptr` if it isn't
+    ///          within the tree.
+    Entry const* find(std::string const& key) const;
+
+    /// \brief Finds a statement that isn't a "USDA_Definition" node or that
+    ///        was made since the index was built.
+    ///
+    /// \param[in] key An object ID encoded by `utils::Operations::make_key()`.
+    /// \returns A pointer to the statement or `nullptr`.
+    Statement* find_statement(std::string const& key);
+
+    AMdoc* get_document() const;
+
+    AMobjId const* get_file_object_id() const;
+
+    /// \brief Adds an object that was made within the tree.
+    ///
+    /// \param[in] key An object ID encoded by `utils::Operations::make_key()`.
+    /// \param[in] entry The object's entry.
+    void insert(std::string const& key, Entry const& entry);
+
+    /// \brief Adds a statement that was made within the tree.
+    ///
+    /// \param[in] key An object ID encoded by `utils::Operations::make_key()`.
+    /// \returns The statement, whose type isn't known yet.
+    Statement& insert_statement(std::string const& key);
+
+    /// \brief Determines whether any of some operations apply to an object
+    ///        within the tree.
+    ///
+    /// \param[in] operations The operations of some changes to the document.
+    /// \returns `true` if the tree was changed.
+    bool is_changed(utils::Operations const& operations) const;
+
+    /// \brief Reads the types and identifiers of some statements that were
+    ///        added to a node's `.statements` property.
+    ///
+    /// \param[in] owner A pointer to the ID of the node's map object.
+    /// \param[in] keys The encoded IDs of the statements.
+    /// \param[in] heads A pointer to the change hashes of a version of the
+    ///                  document that holds the statements.
+    void resolve_statements(AMobjId const* const owner,
+                            std::unordered_set<std::string> const& keys,
+                            AMitems const* const heads);
+
+    /// \brief Gets the count of objects within the tree.
+    std::size_t size() const;
+
+private:
+    using ResultPtr = std::shared_ptr<AMresult>;
+
+    /// \brief Indexes a "USDA_Definition" or "USDA_File" node.
+    ///
+    /// \param[in] object_id A pointer to the ID of the node's map object that
+    ///                      must outlive the index.
+    void index_definition(AMobjId const* const object_id);
+
+    /// \brief Indexes a node's `.statements` property.
+    ///
+    /// \param[in] object_id A pointer to the ID of the property's list object.
+    /// \param[in] owner A pointer to the ID of the node.
+    void index_statements(AMobjId const* const object_id, AMobjId const* const owner);
+
+    /// \brief Indexes an object and every object within it.
+    ///
+    /// \param[in] object_id A pointer to the ID of an object.
+    /// \param[in] entry The entry for each of the objects.
+    void index_object(AMobjId const* const object_id, Entry const& entry);
+
+    AMdoc* m_document;
+    std::unordered_map<std::string, Entry> m_entries;
+    /// \brief The result storing the "USDA_File" node's object ID.
+    ResultPtr m_file_object;
+    /// \brief The results that own the object IDs of the nodes.
+    std::vector<ResultPtr> m_results;
+    std::unordered_map<std::string, Statement> m_statements;
+};
+
+inline AMdoc* SceneIndex::get_document() const {
+    return m_document;
+}
+
+inline std::size_t SceneIndex::size() const {
+    return m_entries.size();
+}
+
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_SCENE_INDEX_HPP
@@ -30,6 +30,7 @@
 #ifndef CAVI_USDJ_AM_STATEMENT_HPP
 #define CAVI_USDJ_AM_STATEMENT_HPP
 
+#include <memory>
 #include <variant>
 
 // local
@@ -44,6 +45,7 @@
 
 struct AMdoc;
 struct AMitem;
+struct AMresult;
 
 namespace cavi {
 namespace usdj_am {
@@ -61,12 +63,16 @@ struct Statement : public std::variant<std::monostate, ClassDefinition, Definiti
 
     /// \param document[in] A pointer to a borrowed Automerge document.
     /// \param map_object[in] A pointer to a borrowed Automerge map object.
+    /// \param type[in] The result of getting the "type" property of
+    ///                 \p map_object if it was already gotten.
     /// \pre \p document `!= nullptr`
     /// \pre \p map_object `!= nullptr`
     /// \pre `AMitemValType(` \p map_object `) == AM_VAL_TYPE_OBJ_TYPE`
     /// \pre `AMobjObjType(` \p document `, AMitemObjId(` \p map_object `)) == AM_OBJ_TYPE_MAP`
     /// \throws std::invalid_argument
-    Statement(AMdoc const* const document, AMitem const* const map_object);
+    Statement(AMdoc const* const document,
+              AMitem const* const map_object,
+              std::shared_ptr<AMresult> const& type = nullptr);
 
     Statement(Statement const&) = delete;
     Statement& operator=(Statement const&) = delete;
@@ -66,6 +66,17 @@ public:
     /// \throws std::invalid_argument
     static Document load(std::filesystem::path const& filename);
 
+    /// \brief Measures the whole chunks at the start of an Automerge document's
+    ///        binary encoding.
+    ///
+    /// \param[in] src A pointer to an array of bytes.
+    /// \param[in] count The number of bytes to read.
+    /// \returns The number of bytes before the first truncated or unrecognized
+    ///          chunk, which is \p count when there are none.
+    /// \note A crash while appending to a file can leave a truncated chunk at
+    ///       its end, which `load()` rejects.
+    static std::size_t get_whole_chunks_size(std::uint8_t const* const src, std::size_t const count);
+
     Document() = delete;
 
     /// \param[in] result A managed pointer to an `AMresult` struct.
@@ -101,8 +112,22 @@ public:
     /// \returns The number of bytes that were written.
     /// \throws std::invalid_argument
     /// \throws std::runtime_error
+    /// \note The file is replaced atomically so that a crash can't leave it
+    ///       partially written.
     std::size_t save(std::filesystem::path const& filename) const;
 
+    /// \brief Appends the changes made to the Automerge document since it was
+    ///        last saved to a binary file.
+    ///
+    /// \param[in] filename A path to a binary file that was the destination of
+    ///                     the previous save.
+    /// \returns The number of bytes that were appended.
+    /// \throws std::invalid_argument
+    /// \note A file that has been appended to is still readable by `load()`.
+    /// \note A failed write is truncated away but a crash can still leave a
+    ///       partial chunk behind; see `get_whole_chunks_size()`.
+    std::size_t save_incremental(std::filesystem::path const& filename) const;
+
 private:
     AMdoc* m_document;
     ResultPtr m_result;
@@ -40,6 +40,9 @@
 
 namespace cavi {
 namespace usdj_am {
+
+class Node;
+
 namespace utils {
 
 /// \brief Writes the contents of a "USDA_File" node into a string.
@@ -83,7 +86,11 @@ public:
     ///        descent.
     /// \param[in] indenter An indent string generator.
     /// \param[in] precision The precision of floating point value output.
-    JsonWriter(Indenter&& indenter, std::size_t const precision = DEFAULT_PRECISION);
+    /// \param[in] materialize Whether to fetch all of a node's properties at
+    ///                        once instead of one at a time.
+    JsonWriter(Indenter&& indenter,
+               std::size_t const precision = DEFAULT_PRECISION,
+               bool const materialize = true);
 
     JsonWriter(JsonWriter const&) = delete;
 
@@ -134,10 +141,16 @@ public:
     void visit(VariantSet const&) override;
 
 private:
+    /// \brief Fetches all of a node's properties at once if configured to.
+    ///
+    /// \param[in] node A node about to be written.
+    void prepare(Node const& node) const;
+
     template <typename InputRangeT>
     void write_array(InputRangeT const& array_range);
 
     Indenter m_indenter;
+    bool const m_materialize;
     std::ostringstream m_os;
     std::size_t const m_precision;
 };
@@ -0,0 +1,174 @@
+/**************************************************************************/
+/* operations.hpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef CAVI_USDJ_AM_UTILS_OPERATIONS_HPP
+#define CAVI_USDJ_AM_UTILS_OPERATIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct AMdoc;
+struct AMitems;
+struct AMobjId;
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+/// \brief The operations within the changes that were made to an Automerge
+///        document between two versions of it.
+///
+/// \note Object and operation IDs are encoded as their counters followed by
+///       their actor IDs' bytes so that they can be matched up with the
+///       object IDs that are read out of the document; see `make_key()`.
+class Operations {
+public:
+    /// \brief A kind of operation, numbered as in Automerge's binary format.
+    enum class Action : std::uint8_t {
+        MAKE_MAP = 0,
+        SET,
+        MAKE_LIST,
+        DEL,
+        MAKE_TEXT,
+        INC,
+        MAKE_TABLE,
+        MARK,
+    };
+
+    struct Operation {
+        Action action;
+        /// \brief Whether a list element was inserted rather than overwritten.
+        bool insert;
+        /// \brief The encoded ID of the operation, which is also the ID of the
+        ///        object that it makes, if any.
+        std::string id;
+        /// \brief The encoded ID of the object that the operation applies to.
+        std::string object;
+        /// \brief The property of the map object that the operation applies
+        ///        to or `std::nullopt` for a list object.
+        std::optional<std::string> key;
+        /// \brief The encoded IDs of the operations that this one overwrites
+        ///        or deletes, which are also the IDs of the objects that they
+        ///        made, if any.
+        std::vector<std::string> predecessors;
+
+        /// \returns `true` if the operation makes an object.
+        bool makes_object() const;
+    };
+
+    using const_iterator = std::vector<Operation>::const_iterator;
+
+    /// \brief Encodes an object ID like the operations' IDs.
+    ///
+    /// \param[in] object_id A pointer to an object ID or `nullptr` for the
+    ///                      root object.
+    /// \returns The object's counter followed by its actor ID's bytes.
+    static std::string make_key(AMobjId const* const object_id);
+
+    Operations() = delete;
+
+    /// \brief Decodes the operations of the changes that were made to a
+    ///        document after one version of it and before another.
+    ///
+    /// \param[in] document A pointer to a borrowed Automerge document.
+    /// \param[in] before_heads A pointer to the change hashes of the earlier
+    ///                         version.
+    /// \param[in] after_heads A pointer to the change hashes of the later
+    ///                        version or `nullptr` for the current one.
+    /// \pre \p document `!= nullptr`
+    /// \throws std::invalid_argument
+    /// \note Only the changes themselves are read, so the cost is proportional
+    ///       to their size rather than to the size of the document.
+    Operations(AMdoc* const document, AMitems const* const before_heads, AMitems const* const after_heads);
+
+    /// \brief Decodes the operations within a sequence of change chunks, e.g.
+    ///        the ones appended by an incremental save.
+    ///
+    /// \param[in] src A pointer to an array of bytes.
+    /// \param[in] count The number of bytes to read.
+    /// \throws std::invalid_argument
+    /// \note Compressed chunks and columns aren't supported.
+    Operations(std::uint8_t const* const src, std::size_t const count);
+
+    const_iterator begin() const;
+
+    bool empty() const;
+
+    const_iterator end() const;
+
+    std::size_t size() const;
+
+private:
+    /// \brief Decodes the operations within a change chunk.
+    ///
+    /// \param[in] src A pointer to an array of bytes.
+    /// \param[in] count The number of bytes to read.
+    /// \returns The number of bytes within the chunk.
+    /// \throws std::invalid_argument
+    std::size_t decode(std::uint8_t const* const src, std::size_t const count);
+
+    std::vector<Operation> m_operations;
+};
+
+inline bool Operations::Operation::makes_object() const {
+    switch (action) {
+        case Action::MAKE_MAP:
+        case Action::MAKE_LIST:
+        case Action::MAKE_TEXT:
+        case Action::MAKE_TABLE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+inline Operations::const_iterator Operations::begin() const {
+    return m_operations.begin();
+}
+
+inline bool Operations::empty() const {
+    return m_operations.empty();
+}
+
+inline Operations::const_iterator Operations::end() const {
+    return m_operations.end();
+}
+
+inline std::size_t Operations::size() const {
+    return m_operations.size();
+}
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_UTILS_OPERATIONS_HPP
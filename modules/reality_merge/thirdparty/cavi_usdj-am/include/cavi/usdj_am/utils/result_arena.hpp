@@ -0,0 +1,108 @@
+/**************************************************************************/
+/* result_arena.hpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef CAVI_USDJ_AM_UTILS_RESULT_ARENA_HPP
+#define CAVI_USDJ_AM_UTILS_RESULT_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+struct AMresult;
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+/// \brief A scope that owns every Automerge result which is produced by a node
+///        within it and frees them all at once when it ends.
+///
+/// \warning A node created within an arena's scope must not outlive it, nor
+///          may an Automerge item that's passed into the node.
+/// \note A node created within an arena keeps each of its properties until
+///       the arena ends instead of releasing it, so a property that's read
+///       again isn't fetched again. An arena's size therefore grows with the
+///       nodes created in its scope and the properties that they read.
+/// \note A node created outside of an arena owns the properties that it reads
+///       within one so that they outlive the arena.
+/// \note Arenas are per thread and they can be nested, in which case only the
+///       innermost one takes ownership of a result.
+class ResultArena {
+public:
+    /// \brief Begins the scope of the arena on the current thread.
+    ResultArena();
+
+    ResultArena(ResultArena const&) = delete;
+
+    ResultArena(ResultArena&&) = delete;
+
+    /// \brief Ends the scope of the arena and frees all of its results.
+    ~ResultArena();
+
+    ResultArena& operator=(ResultArena const&) = delete;
+
+    ResultArena& operator=(ResultArena&&) = delete;
+
+    /// \brief Takes ownership of an Automerge result on behalf of the innermost
+    ///        arena on the current thread, if any.
+    ///
+    /// \param result[in] A pointer to an Automerge result or `nullptr`.
+    /// \return A non-owning pointer to \p result when there's an arena, which
+    ///         neither allocates nor counts references when copied, or else a
+    ///         pointer that frees \p result when its last copy is destroyed.
+    static std::shared_ptr<AMresult> adopt(AMresult* const result);
+
+    /// \brief Takes ownership of an Automerge result on behalf of an arena if
+    ///        it's the innermost one on the current thread.
+    ///
+    /// \param result[in] A pointer to an Automerge result or `nullptr`.
+    /// \param arena[in] A pointer to an arena or `nullptr`.
+    /// \return A non-owning pointer to \p result when \p arena is the
+    ///         innermost one, or else a pointer that frees \p result when its
+    ///         last copy is destroyed.
+    static std::shared_ptr<AMresult> adopt(AMresult* const result, ResultArena* const arena);
+
+    /// \brief Gets the innermost arena on the current thread.
+    ///
+    /// \return A pointer to an arena or `nullptr`.
+    static ResultArena* get_current();
+
+    /// \brief Gets the count of results owned by the arena.
+    std::size_t size() const;
+
+private:
+    ResultArena* const m_enclosing;
+    std::vector<AMresult*> m_results;
+};
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
+
+#endif  // CAVI_USDJ_AM_UTILS_RESULT_ARENA_HPP
@@ -45,11 +45,13 @@ extern "C" {
 #include "class_definition.hpp"
 #include "definition.hpp"
 #include "definition_statement.hpp"
+#include "detail/arguments.hpp"
 #include "external_reference.hpp"
 #include "object_declaration.hpp"
 #include "object_declaration_list_value.hpp"
 #include "object_value.hpp"
 #include "statement.hpp"
+#include "utils/result_arena.hpp"
 #include "value.hpp"
 #include "variant_definition.hpp"
 #include "variant_set.hpp"
@@ -58,48 +60,56 @@ namespace cavi {
 namespace usdj_am {
 
 template <typename T>
-ArrayInputIterator<T>::ArrayInputIterator() : m_document{nullptr} {}
+ArrayInputIterator<T>::ArrayInputIterator()
+    : m_document{nullptr}, m_arena{nullptr}, m_index{0}, m_size{0}, m_chunk_size{0}, m_chunk_index{0} {}
 
 template <typename T>
 ArrayInputIterator<T>::~ArrayInputIterator() {}
 
 template <typename T>
-ArrayInputIterator<T>::ArrayInputIterator(AMdoc const* const document, AMitem const* const list_object)
-    : m_document{document} {
-    std::ostringstream args;
+ArrayInputIterator<T>::ArrayInputIterator(AMdoc const* const document,
+                                          AMitem const* const list_object,
+                                          std::size_t const index,
+                                          std::size_t const chunk_size)
+    : m_document{document},
+      m_arena{utils::ResultArena::get_current()},
+      m_index{index},
+      m_size{0},
+      m_chunk_size{chunk_size},
+      m_chunk_index{0} {
+    detail::Arguments args;
     if (!document) {
-        args << "document == nullptr, ..., ...";
+        args << "document == nullptr, ..., ..., ...";
     } else if (!list_object) {
-        args << "..., list_object == nullptr, ...";
+        args << "..., list_object == nullptr, ..., ...";
     } else {
         AMvalType const val_type = AMitemValType(list_object);
         if (val_type != AM_VAL_TYPE_OBJ_TYPE) {
             args << "..., "
-                 << "AMitemValType(list_object) == " << AMvalTypeToString(val_type) << ", ...";
+                 << "AMitemValType(list_object) == " << AMvalTypeToString(val_type) << ", ..., ...";
         } else {
             AMobjType const obj_type = AMobjObjType(document, AMitemObjId(list_object));
             if (obj_type != AM_OBJ_TYPE_LIST) {
                 args << "AMobjObjType(document, AMitemObjId(list_object)) == " << AMobjTypeToString(obj_type)
-                     << ", ...";
+                     << ", ..., ...";
             }
         }
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
     }
     // Preserve the AMitem storing the list object's ID.
-    m_results[OBJ_ID] = ResultPtr{AMitemResult(list_object), AMresultFree};
-    // Preserve the AMitems storing the list object's contents.
-    m_results[ITEMS] = ResultPtr{AMobjItems(document, AMitemObjId(list_object), nullptr), AMresultFree};
-    m_items = AMresultItems(m_results[ITEMS].get());
+    m_results[OBJ_ID] = utils::ResultArena::adopt(AMitemResult(list_object));
+    // The elements are only fetched when they're dereferenced.
+    m_size = AMobjSize(document, AMitemObjId(list_object), nullptr);
 }
 
 template <typename T>
 ArrayInputIterator<T>& ArrayInputIterator<T>::operator++() {
-    if (m_items) {
-        AMitemsAdvance(&*m_items, 1);
+    if (!is_end()) {
+        ++m_index;
     }
     return *this;
 }
@@ -113,22 +123,58 @@ ArrayInputIterator<T> ArrayInputIterator<T>::operator++(int) {
 
 template <typename T>
 T ArrayInputIterator<T>::operator*() {
-    AMitem const* const item = (m_items) ? AMitemsNext(&*m_items, 0) : nullptr;
-    if (item) {
-        return T{m_document, item};
-    } else {
+    if (is_end()) {
         return T{};
     }
+    if (m_chunk_size > 1) {
+        AMitem const* const item = get_chunk_item();
+        if (item) {
+            return T{m_document, item};
+        }
+    } else {
+        ResultPtr const result{
+            AMlistGet(m_document, AMitemObjId(AMresultItem(m_results[OBJ_ID].get())), m_index, nullptr),
+            AMresultFree};
+        AMitem const* const item =
+            (AMresultStatus(result.get()) == AM_STATUS_OK) ? AMresultItem(result.get()) : nullptr;
+        if (item) {
+            return T{m_document, item};
+        }
+    }
+    return T{};
+}
+
+template <typename T>
+AMitem const* ArrayInputIterator<T>::get_chunk_item() {
+    if (!m_chunk || m_index < m_chunk_index || m_index >= m_chunk_index + AMitemsSize(&*m_chunk)) {
+        // Fetch the chunk that starts at the current position.
+        std::size_t const end = (m_size - m_index > m_chunk_size) ? m_index + m_chunk_size : m_size;
+        m_results[CHUNK] = utils::ResultArena::adopt(
+            AMlistRange(m_document, AMitemObjId(AMresultItem(m_results[OBJ_ID].get())), m_index, end, nullptr),
+            m_arena);
+        if (AMresultStatus(m_results[CHUNK].get()) != AM_STATUS_OK) {
+            m_chunk.reset();
+            return nullptr;
+        }
+        m_chunk = AMresultItems(m_results[CHUNK].get());
+        m_chunk_index = m_index;
+    }
+    AMitems items = *m_chunk;
+    AMitemsAdvance(&items, m_index - m_chunk_index);
+    return AMitemsNext(&items, 0);
+}
+
+template <typename T>
+bool ArrayInputIterator<T>::is_end() const {
+    return !m_document || (m_index >= m_size);
 }
 
 template <typename T>
 bool operator==(ArrayInputIterator<T> const& lhs, ArrayInputIterator<T> const& rhs) {
-    AMitem const* const lhs_item =
-        (lhs.m_items) ? AMitemsNext(const_cast<AMitems*>(lhs.m_items.operator->()), 0) : nullptr;
-    AMitem const* const rhs_item =
-        (rhs.m_items) ? AMitemsNext(const_cast<AMitems*>(rhs.m_items.operator->()), 0) : nullptr;
-    /// \note `AMitemEqual(nullptr, nullptr) == false`.
-    return (lhs_item == rhs_item) || AMitemEqual(lhs_item, rhs_item);
+    // Any iterator that's past the last element equals the default one.
+    bool const lhs_end = lhs.is_end();
+    bool const rhs_end = rhs.is_end();
+    return (lhs_end || rhs_end) ? (lhs_end == rhs_end) : (lhs.m_index == rhs.m_index);
 }
 
 template <typename T>
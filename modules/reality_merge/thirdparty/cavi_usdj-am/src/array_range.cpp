@@ -28,6 +28,9 @@
 /**************************************************************************/
 
 #include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
 
 // local
 #include "array_range.hpp"
@@ -38,6 +41,7 @@
 #include "object_declaration.hpp"
 #include "object_declaration_list_value.hpp"
 #include "statement.hpp"
+#include "utils/result_arena.hpp"
 #include "value.hpp"
 #include "variant_definition.hpp"
 
@@ -56,11 +60,13 @@ bool operator!=(ArrayInputRange<T> const& lhs, ArrayInputRange<T> const& rhs) {
 
 template <typename T>
 ArrayInputRange<T>::ArrayInputRange(AMdoc const* const document, AMitem const* const list_object)
-    : m_document{document}, m_result{AMitemResult(list_object), AMresultFree} {}
+    : m_document{document},
+      m_result{utils::ResultArena::adopt(AMitemResult(list_object))},
+      m_chunk_size{DEFAULT_CHUNK_SIZE} {}
 
 template <typename T>
 ArrayInputIterator<T> ArrayInputRange<T>::begin() const {
-    return ArrayInputIterator<T>{m_document, AMresultItem(m_result.get())};
+    return ArrayInputIterator<T>{m_document, AMresultItem(m_result.get()), 0, m_chunk_size};
 }
 
 template <typename T>
@@ -68,6 +74,17 @@ ArrayInputIterator<T> ArrayInputRange<T>::end() const {
     return ArrayInputIterator<T>{};
 }
 
+template <typename T>
+T ArrayInputRange<T>::operator[](std::size_t const index) const {
+    ArrayInputIterator<T> iter{m_document, AMresultItem(m_result.get()), index};
+    if (iter == end()) {
+        std::ostringstream what;
+        what << typeid(*this).name() << "::" << __func__ << "(index == " << index << ")";
+        throw std::out_of_range(what.str());
+    }
+    return *iter;
+}
+
 template <typename T>
 std::size_t ArrayInputRange<T>::size() const {
     return AMobjSize(m_document, get_object_id(), nullptr);
@@ -83,6 +100,16 @@ AMobjId const* ArrayInputRange<T>::get_object_id() const {
     return AMitemObjId(AMresultItem(m_result.get()));
 }
 
+template <typename T>
+std::size_t ArrayInputRange<T>::get_chunk_size() const {
+    return m_chunk_size;
+}
+
+template <typename T>
+void ArrayInputRange<T>::set_chunk_size(std::size_t const chunk_size) {
+    m_chunk_size = chunk_size;
+}
+
 template class ArrayInputRange<Assignment>;
 
 template class ArrayInputRange<ClassDeclaration>;
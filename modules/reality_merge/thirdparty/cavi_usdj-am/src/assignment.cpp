@@ -27,8 +27,10 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
 #include <iostream>
 #include <map>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -180,11 +182,30 @@ static std::map<std::string_view, AssignmentType> const TAGS = {{"assignment", A
 
 }  // namespace
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property IDENTIFIER{0, "identifier"};
+constexpr Node::Property KEYWORD{1, "keyword"};
+constexpr Node::Property TYPE{2, "type"};
+constexpr Node::Property VALUE{3, "value"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 4> ALL = {IDENTIFIER, KEYWORD, TYPE, VALUE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
-Assignment::Assignment(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 4) {
-    check_enum_property("type", AssignmentType::ASSIGNMENT);
+Assignment::Assignment(AMdoc const* const document, AMitem const* const map_object)
+    : Node(document, map_object, property::ALL) {
+    check_enum_property(property::TYPE, AssignmentType::ASSIGNMENT);
 }
 
 void Assignment::accept(Visitor& visitor) const& {
@@ -196,15 +217,23 @@ void Assignment::accept(Visitor& visitor) && {
 }
 
 String Assignment::get_identifier() const {
-    return get_object_property<String>("identifier");
+    return get_object_property<String>(property::IDENTIFIER);
 }
 
 std::optional<AssignmentKeyword> Assignment::get_keyword() const {
-    return get_nullable_enum_property<AssignmentKeyword>("keyword");
+    return get_nullable_enum_property<AssignmentKeyword>(property::KEYWORD);
 }
 
 Value Assignment::get_value() const {
-    return get_object_property<Value>("value");
+    return get_object_property<Value>(property::VALUE);
+}
+
+std::optional<AssignmentType> extract_AssignmentType(std::string_view const& view) {
+    auto const match = TAGS.find(view);
+    if (match != TAGS.end()) {
+        return match->second;
+    }
+    return std::nullopt;
 }
 
 std::istream& operator>>(std::istream& is, AssignmentType& out) {
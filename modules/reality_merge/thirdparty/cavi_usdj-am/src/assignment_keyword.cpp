@@ -29,6 +29,7 @@
 
 #include <iostream>
 #include <map>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -51,6 +52,14 @@ static std::map<std::string_view, AssignmentKeyword> const TAGS = {
 namespace cavi {
 namespace usdj_am {
 
+std::optional<AssignmentKeyword> extract_AssignmentKeyword(std::string_view const& view) {
+    auto const match = TAGS.find(view);
+    if (match != TAGS.end()) {
+        return match->second;
+    }
+    return std::nullopt;
+}
+
 std::istream& operator>>(std::istream& is, AssignmentKeyword& out) {
     std::string token;
     if (is >> token) {
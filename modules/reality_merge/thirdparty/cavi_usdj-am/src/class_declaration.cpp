@@ -27,6 +27,8 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
@@ -40,6 +42,8 @@ extern "C" {
 
 // local
 #include "class_declaration.hpp"
+#include "detail/arguments.hpp"
+#include "detail/map_type.hpp"
 #include "statement_type.hpp"
 #include "visitor.hpp"
 
@@ -47,34 +51,28 @@ namespace cavi {
 namespace usdj_am {
 
 ClassDeclaration::ClassDeclaration(AMdoc const* const document, AMitem const* const map_object) {
-    using Index = typename std::underlying_type<StatementType>::type;
-
-    std::ostringstream args;
-    for (Index index = static_cast<Index>(StatementType::BEGIN__); index != static_cast<Index>(StatementType::END__);
-         ++index) {
-        try {
-            switch (static_cast<StatementType>(index)) {
-                case StatementType::DECLARATION: {
-                    this->emplace<Declaration>(document, map_object);
-                    break;
-                }
-                case StatementType::DEFINITION: {
-                    this->emplace<Definition>(document, map_object);
-                    break;
-                }
-                default:
-                    continue;
+    // Only construct the alternative named by the map object's type and let it
+    // reuse the type instead of getting it again.
+    std::shared_ptr<AMresult> type;
+    auto const tag = detail::extract_map_type(document, map_object, extract_StatementType, type);
+    detail::Arguments args;
+    try {
+        switch (tag.value_or(StatementType::END__)) {
+            case StatementType::DECLARATION: {
+                this->emplace<Declaration>(document, map_object, type);
+                break;
             }
-            args.str("");
-            break;
-        } catch (std::invalid_argument const& thrown) {
-            if (!args.str().empty()) {
-                args << " | ";
+            case StatementType::DEFINITION: {
+                this->emplace<Definition>(document, map_object, type);
+                break;
             }
-            args << thrown.what();
+            default:
+                detail::describe_map_type(document, map_object, type.get(), args);
         }
+    } catch (std::invalid_argument const& thrown) {
+        args << thrown.what();
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
@@ -27,18 +27,42 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "class_definition.hpp"
 #include "class_declaration.hpp"
 #include "descriptor.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property CLASS_DECLARATIONS{0, "classDeclarations"};
+constexpr Node::Property DESCRIPTOR{1, "descriptor"};
+constexpr Node::Property ID{2, "id"};
+constexpr Node::Property NAME{3, "name"};
+constexpr Node::Property TYPE{4, "type"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 5> ALL = {CLASS_DECLARATIONS, DESCRIPTOR, ID, NAME, TYPE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
-ClassDefinition::ClassDefinition(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 5) {
-    check_enum_property("type", StatementType::CLASS_DEFINITION);
+ClassDefinition::ClassDefinition(AMdoc const* const document,
+                                 AMitem const* const map_object,
+                                 std::shared_ptr<AMresult> const& type)
+    : Node(document, map_object, property::ALL) {
+    reuse_property(property::TYPE, type);
+    check_enum_property(property::TYPE, StatementType::CLASS_DEFINITION);
 }
 
 void ClassDefinition::accept(Visitor& visitor) const& {
@@ -50,19 +74,19 @@ void ClassDefinition::accept(Visitor& visitor) && {
 }
 
 ClassDefinition::ClassDeclarations ClassDefinition::get_class_declarations() const {
-    return get_array_property<ClassDeclarations>("classDeclarations");
+    return get_array_property<ClassDeclarations>(property::CLASS_DECLARATIONS);
 }
 
 std::optional<Descriptor> ClassDefinition::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(property::DESCRIPTOR);
 }
 
 std::optional<String> ClassDefinition::get_id() const {
-    return get_nullable_object_property<String>("id");
+    return get_nullable_object_property<String>(property::ID);
 }
 
 String ClassDefinition::get_name() const {
-    return get_object_property<String>("name");
+    return get_object_property<String>(property::NAME);
 }
 
 }  // namespace usdj_am
@@ -27,17 +27,43 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "declaration.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property DEFINE_TYPE{0, "defineType"};
+constexpr Node::Property DESCRIPTOR{1, "descriptor"};
+constexpr Node::Property KEYWORD{2, "keyword"};
+constexpr Node::Property REFERENCE{3, "reference"};
+constexpr Node::Property TYPE{4, "type"};
+constexpr Node::Property VALUE{5, "value"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 6> ALL = {DEFINE_TYPE, DESCRIPTOR, KEYWORD, REFERENCE, TYPE, VALUE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 Declaration::Declaration() {}
 
-Declaration::Declaration(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 6) {
-    check_enum_property("type", StatementType::DECLARATION);
+Declaration::Declaration(AMdoc const* const document,
+                         AMitem const* const map_object,
+                         std::shared_ptr<AMresult> const& type)
+    : Node(document, map_object, property::ALL) {
+    reuse_property(property::TYPE, type);
+    check_enum_property(property::TYPE, StatementType::DECLARATION);
 }
 
 void Declaration::accept(Visitor& visitor) const& {
@@ -49,23 +75,23 @@ void Declaration::accept(Visitor& visitor) && {
 }
 
 Typename Declaration::get_define_type() const {
-    return get_object_property<String>("defineType");
+    return get_object_property<String>(property::DEFINE_TYPE);
 }
 
 std::optional<Descriptor> Declaration::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(property::DESCRIPTOR);
 }
 
 std::optional<DeclarationKeyword> Declaration::get_keyword() const {
-    return get_nullable_enum_property<DeclarationKeyword>("keyword");
+    return get_nullable_enum_property<DeclarationKeyword>(property::KEYWORD);
 }
 
 String Declaration::get_reference() const {
-    return get_object_property<String>("reference");
+    return get_object_property<String>(property::REFERENCE);
 }
 
 Value Declaration::get_value() const {
-    return get_object_property<Value>("value");
+    return get_object_property<Value>(property::VALUE);
 }
 
 }  // namespace usdj_am
@@ -27,18 +27,44 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "definition.hpp"
 #include "descriptor.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property DEF_TYPE{0, "defType"};
+constexpr Node::Property DESCRIPTOR{1, "descriptor"};
+constexpr Node::Property NAME{2, "name"};
+constexpr Node::Property STATEMENTS{3, "statements"};
+constexpr Node::Property SUB_TYPE{4, "subType"};
+constexpr Node::Property TYPE{5, "type"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 6> ALL = {DEF_TYPE, DESCRIPTOR, NAME, STATEMENTS, SUB_TYPE, TYPE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 Definition::Definition() {}
 
-Definition::Definition(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 6) {
-    check_enum_property("type", StatementType::DEFINITION);
+Definition::Definition(AMdoc const* const document,
+                       AMitem const* const map_object,
+                       std::shared_ptr<AMresult> const& type)
+    : Node(document, map_object, property::ALL) {
+    reuse_property(property::TYPE, type);
+    check_enum_property(property::TYPE, StatementType::DEFINITION);
 }
 
 void Definition::accept(Visitor& visitor) const& {
@@ -50,23 +76,23 @@ void Definition::accept(Visitor& visitor) && {
 }
 
 std::optional<Typename> Definition::get_def_type() const {
-    return get_nullable_object_property<String>("defType");
+    return get_nullable_object_property<String>(property::DEF_TYPE);
 }
 
 std::optional<Descriptor> Definition::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(property::DESCRIPTOR);
 }
 
 String Definition::get_name() const {
-    return get_object_property<String>("name");
+    return get_object_property<String>(property::NAME);
 }
 
 Definition::Statements Definition::get_statements() const {
-    return get_array_property<Statements>("statements");
+    return get_array_property<Statements>(property::STATEMENTS);
 }
 
 DefinitionType Definition::get_sub_type() const {
-    return get_enum_property<DefinitionType>("subType");
+    return get_enum_property<DefinitionType>(property::SUB_TYPE);
 }
 
 }  // namespace usdj_am
@@ -27,7 +27,8 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <cstddef>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <typeinfo>
@@ -40,37 +41,32 @@ extern "C" {
 
 // local
 #include "definition_statement.hpp"
+#include "detail/arguments.hpp"
+#include "detail/map_type.hpp"
+#include "statement_type.hpp"
 #include "visitor.hpp"
 
 namespace cavi {
 namespace usdj_am {
 
 DefinitionStatement::DefinitionStatement(AMdoc const* const document, AMitem const* const map_object) {
-    enum { BEGIN__, STATEMENT = BEGIN__, DECLARATION, END__, SIZE__ = END__ - BEGIN__ };
-
-    std::ostringstream args;
-    for (std::size_t index = BEGIN__; index != END__; ++index) {
-        try {
-            switch (index) {
-                case DECLARATION: {
-                    this->emplace<Declaration>(document, map_object);
-                    break;
-                }
-                case STATEMENT: {
-                    this->emplace<Statement>(document, map_object);
-                    break;
-                }
-            }
-            args.str("");
-            break;
-        } catch (std::invalid_argument const& thrown) {
-            if (!args.str().empty()) {
-                args << " | ";
-            }
-            args << thrown.what();
+    // Only construct the alternative named by the map object's type and let it
+    // reuse the type instead of getting it again.
+    std::shared_ptr<AMresult> type;
+    auto const tag = detail::extract_map_type(document, map_object, extract_StatementType, type);
+    detail::Arguments args;
+    try {
+        if (!tag) {
+            detail::describe_map_type(document, map_object, type.get(), args);
+        } else if (*tag == StatementType::DECLARATION) {
+            this->emplace<Declaration>(document, map_object, type);
+        } else {
+            this->emplace<Statement>(document, map_object, type);
         }
+    } catch (std::invalid_argument const& thrown) {
+        args << thrown.what();
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
@@ -29,6 +29,7 @@
 
 #include <iostream>
 #include <map>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -47,6 +48,14 @@ static std::map<std::string_view, DefinitionType> const TAGS = {{"def", Definiti
 namespace cavi {
 namespace usdj_am {
 
+std::optional<DefinitionType> extract_DefinitionType(std::string_view const& view) {
+    auto const match = TAGS.find(view);
+    if (match != TAGS.end()) {
+        return match->second;
+    }
+    return std::nullopt;
+}
+
 std::istream& operator>>(std::istream& is, DefinitionType& out) {
     std::string token;
     if (is >> token) {
@@ -27,6 +27,7 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
 #include <cassert>
 
 // third-party
@@ -165,10 +166,27 @@ extern "C" {
 //     | null
 //     | undefined
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property ASSIGNMENTS{0, "assignments"};
+constexpr Node::Property DESCRIPTION{1, "description"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 2> ALL = {ASSIGNMENTS, DESCRIPTION};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
-Descriptor::Descriptor(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 2) {}
+Descriptor::Descriptor(AMdoc const* const document, AMitem const* const map_object)
+    : Node(document, map_object, property::ALL) {}
 
 void Descriptor::accept(Visitor& visitor) const& {
     visitor.visit(*this);
@@ -179,11 +197,11 @@ void Descriptor::accept(Visitor& visitor) && {
 }
 
 Descriptor::Assignments Descriptor::get_assignments() const {
-    return get_array_property<Assignments>("assignments");
+    return get_array_property<Assignments>(property::ASSIGNMENTS);
 }
 
 std::optional<String> Descriptor::get_description() const {
-    return get_nullable_object_property<String>("description");
+    return get_nullable_object_property<String>(property::DESCRIPTION);
 }
 
 }  // namespace usdj_am
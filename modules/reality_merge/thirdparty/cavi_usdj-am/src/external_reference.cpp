@@ -27,17 +27,36 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "external_reference.hpp"
 #include "reference_file.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property REFERENCE_FILE{0, "referenceFile"};
+constexpr Node::Property TO_IMPORT{1, "toImport"};
+constexpr Node::Property TYPE{2, "type"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 3> ALL = {REFERENCE_FILE, TO_IMPORT, TYPE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 ExternalReference::ExternalReference(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 3) {
-    check_enum_property("type", ValueType::EXTERNAL_REFERENCE);
+    : Node(document, map_object, property::ALL) {
+    check_enum_property(property::TYPE, ValueType::EXTERNAL_REFERENCE);
 }
 
 void ExternalReference::accept(Visitor& visitor) const& {
@@ -49,11 +68,11 @@ void ExternalReference::accept(Visitor& visitor) && {
 }
 
 ReferenceFile ExternalReference::get_reference_file() const {
-    return get_object_property<ReferenceFile>("referenceFile");
+    return get_object_property<ReferenceFile>(property::REFERENCE_FILE);
 }
 
 std::optional<ExternalReferenceImport> ExternalReference::get_to_import() const {
-    return get_nullable_object_property<ExternalReferenceImport>("toImport");
+    return get_nullable_object_property<ExternalReferenceImport>(property::TO_IMPORT);
 }
 
 }  // namespace usdj_am
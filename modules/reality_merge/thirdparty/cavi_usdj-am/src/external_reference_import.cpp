@@ -27,16 +27,35 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "external_reference_import.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property FIELD{0, "field"};
+constexpr Node::Property IMPORT_PATH{1, "importPath"};
+constexpr Node::Property TYPE{2, "type"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 3> ALL = {FIELD, IMPORT_PATH, TYPE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 ExternalReferenceImport::ExternalReferenceImport(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 3) {
-    check_enum_property("type", ValueType::EXTERNAL_REFERENCE_IMPORT);
+    : Node(document, map_object, property::ALL) {
+    check_enum_property(property::TYPE, ValueType::EXTERNAL_REFERENCE_IMPORT);
 }
 
 void ExternalReferenceImport::accept(Visitor& visitor) const& {
@@ -48,11 +67,11 @@ void ExternalReferenceImport::accept(Visitor& visitor) && {
 }
 
 std::optional<String> ExternalReferenceImport::get_field() const {
-    return get_nullable_object_property<String>("field");
+    return get_nullable_object_property<String>(property::FIELD);
 }
 
 String ExternalReferenceImport::get_import_path() const {
-    return get_object_property<String>("importPath");
+    return get_object_property<String>(property::IMPORT_PATH);
 }
 
 }  // namespace usdj_am
@@ -27,6 +27,7 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
 #include <cstddef>
 
 // third-party
@@ -38,17 +39,36 @@ extern "C" {
 
 // local
 #include "descriptor.hpp"
+#include "detail/arguments.hpp"
 #include "file.hpp"
 #include "statement.hpp"
+#include "utils/result_arena.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property DESCRIPTOR{0, "descriptor"};
+constexpr Node::Property STATEMENTS{1, "statements"};
+constexpr Node::Property VERSION{2, "version"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 3> ALL = {DESCRIPTOR, STATEMENTS, VERSION};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
-File::File(AMdoc const* const document, AMitem const* const map_object) : Node(document) {
-    static const std::size_t MAP_SIZE = 3;
+File::File(AMdoc const* const document, AMitem const* const map_object) : Node(document, property::ALL) {
+    static const std::size_t MAP_SIZE = property::ALL.size();
 
-    std::ostringstream args;
+    detail::Arguments args;
     if (!document) {
         args << "document == nullptr, ...";
     } else {
@@ -66,18 +86,17 @@ File::File(AMdoc const* const document, AMitem const* const map_object) : Node(d
                 }
             }
         }
-        if (args.str().empty()) {
+        if (!args) {
             std::size_t const obj_size = AMobjSize(document, obj_id, nullptr);
             if (obj_size != MAP_SIZE) {
                 args << "AMobjSize(document, AMitemObjId(map_object), nullptr) == " << obj_size << ", " << MAP_SIZE;
             } else if (map_object) {
                 // Preserve the AMitem storing the node's object ID.
-                ResultPtr const result{AMitemResult(map_object), AMresultFree};
-                m_results.insert_or_assign("", result);
+                m_map_object = utils::ResultArena::adopt(AMitemResult(map_object));
             }
         }
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
@@ -93,7 +112,7 @@ void File::accept(Visitor& visitor) && {
 }
 
 AMobjId const* File::get_object_id() const {
-    if (m_results.count("")) {
+    if (m_map_object) {
         return Node::get_object_id();
     } else {
         // The map object is the document itself.
@@ -102,15 +121,15 @@ AMobjId const* File::get_object_id() const {
 }
 
 Number File::get_version() const {
-    return get_object_property<Number>("version");
+    return get_object_property<Number>(property::VERSION);
 }
 
 std::optional<Descriptor> File::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(property::DESCRIPTOR);
 }
 
 File::Statements File::get_statements() const {
-    return get_array_property<Statements>("statements");
+    return get_array_property<Statements>(property::STATEMENTS);
 }
 
 }  // namespace usdj_am
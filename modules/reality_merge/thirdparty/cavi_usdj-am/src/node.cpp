@@ -27,7 +27,11 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
 #include <string_view>
 #include <typeinfo>
@@ -46,6 +50,7 @@ extern "C" {
 #include "definition.hpp"
 #include "definition_type.hpp"
 #include "descriptor.hpp"
+#include "detail/arguments.hpp"
 #include "external_reference_import.hpp"
 #include "file.hpp"
 #include "node.hpp"
@@ -55,6 +60,8 @@ extern "C" {
 #include "object_declarations.hpp"
 #include "reference_file.hpp"
 #include "statement_type.hpp"
+#include "utils/bytes.hpp"
+#include "utils/result_arena.hpp"
 #include "value.hpp"
 #include "value_type.hpp"
 #include "variant_definition.hpp"
@@ -62,27 +69,109 @@ extern "C" {
 
 namespace cavi {
 namespace usdj_am {
+namespace {
+
+/// \brief The count of calls made into Automerge by all nodes to fetch their
+///        properties.
+std::atomic<std::uint64_t> fetch_count{0};
+
+/// \brief Extracts an enum tag from a UTF-8 string view.
+///
+/// \tparam EnumT A type of enum.
+/// \param[in] view A UTF-8 string view.
+/// \returns The \p EnumT tag whose serialized form is \p view or
+///          `std::nullopt`.
+template <typename EnumT>
+std::optional<EnumT> extract_tag(std::string_view const& view);
 
-Node::Node(AMdoc const* const document) : m_document{document} {
-    std::ostringstream args;
+template <>
+std::optional<AssignmentKeyword> extract_tag(std::string_view const& view) {
+    return extract_AssignmentKeyword(view);
+}
+
+template <>
+std::optional<AssignmentType> extract_tag(std::string_view const& view) {
+    return extract_AssignmentType(view);
+}
+
+template <>
+std::optional<DeclarationKeyword> extract_tag(std::string_view const& view) {
+    return extract_DeclarationKeyword(view);
+}
+
+template <>
+std::optional<DefinitionType> extract_tag(std::string_view const& view) {
+    return extract_DefinitionType(view);
+}
+
+template <>
+std::optional<StatementType> extract_tag(std::string_view const& view) {
+    return extract_StatementType(view);
+}
+
+template <>
+std::optional<ValueType> extract_tag(std::string_view const& view) {
+    return extract_ValueType(view);
+}
+
+/// \brief Extracts an enum tag from an Automerge string or text object
+///        without throwing.
+///
+/// \tparam EnumT A type of enum.
+/// \param[in] document A pointer to a borrowed Automerge document.
+/// \param[in] item A pointer to a borrowed Automerge item or `nullptr`.
+/// \returns The \p EnumT tag whose serialized form is stored by \p item or
+///          `std::nullopt`.
+template <typename EnumT>
+std::optional<EnumT> extract_item_tag(AMdoc const* const document, AMitem const* const item) {
+    if (!item) {
+        return std::nullopt;
+    }
+    AMbyteSpan str;
+    if (AMitemToStr(item, &str)) {
+        return extract_tag<EnumT>(utils::from_bytes(str));
+    } else if (AMitemValType(item) == AM_VAL_TYPE_OBJ_TYPE &&
+               AMobjObjType(document, AMitemObjId(item)) == AM_OBJ_TYPE_TEXT) {
+        return extract_tag<EnumT>(String{document, item});
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+Node::Node(AMdoc const* const document, Properties const properties)
+    : m_document{document},
+      m_arena{utils::ResultArena::get_current()},
+      m_map_object{},
+      m_properties{properties},
+      m_results{},
+      m_items{} {
+    detail::Arguments args;
     if (!document) {
-        args << "document == nullptr";
+        args << "document == nullptr, ...";
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
     }
 }
 
-Node::Node(AMdoc const* const document, AMitem const* const map_object, int const map_size) : m_document{document} {
-    std::ostringstream args;
+Node::Node(AMdoc const* const document, AMitem const* const map_object, Properties const properties)
+    : m_document{document},
+      m_arena{utils::ResultArena::get_current()},
+      m_map_object{},
+      m_properties{properties},
+      m_results{},
+      m_items{} {
+    std::size_t const map_size = properties.size();
+    detail::Arguments args;
     if (!document) {
         args << "document == nullptr, ..., ...";
     } else if (!map_object) {
         args << "..., map_object == nullptr, ...";
-    } else if (!(map_size > 0)) {
-        args << "..., ..., map_size == " << map_size;
+    } else if (map_size == 0) {
+        args << "..., ..., properties.size() == " << map_size;
     } else {
         AMvalType const val_type = AMitemValType(map_object);
         if (val_type != AM_VAL_TYPE_OBJ_TYPE) {
@@ -101,131 +190,195 @@ Node::Node(AMdoc const* const document, AMitem const* const map_object, int cons
             }
         }
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
     }
     // Preserve the AMitem storing the node's object ID.
-    ResultPtr result{AMitemResult(map_object), AMresultFree};
-    m_results.insert_or_assign("", result);
+    m_map_object = utils::ResultArena::adopt(AMitemResult(map_object));
 }
 
 Node::~Node() {}
 
 template <typename EnumT>
-void Node::check_enum_property(std::string const& key, EnumT const tag) const {
-    std::ostringstream args;
-    try {
-        if (get_enum_property<EnumT>(key) != tag) {
-            args << "AMmapGet(m_document, ..., AMstr(\"" << key << "\"), nullptr) == \""
-                 << get_object_property<String>(key) << "\", \"" << tag << "\"";
+void Node::check_enum_property(Property const& property, EnumT const tag) const {
+    detail::Arguments args;
+    if (find_enum_property<EnumT>(property) != tag) {
+        // Describe the mismatch only now that it's certain.
+        try {
+            auto const string = get_object_property<String>(property);
+            args << "AMmapGet(m_document, ..., AMstr(\"" << property.key << "\"), nullptr) == \"" << string << "\", \""
+                 << tag << "\"";
+        } catch (std::invalid_argument const& thrown) {
+            args << thrown.what();
         }
-    } catch (std::invalid_argument const& thrown) {
-        args << thrown.what();
     }
-    // Free the AMresult because we're finished with it.
-    m_results.erase(key);
-    if (!args.str().empty()) {
+    release_property(property);
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
     }
 }
 
-void Node::check_string_property(std::string const& key, std::string const& value) const {
-    std::ostringstream args;
-    try {
-        auto const property = get_object_property<String>(key);
-        if (property != value) {
-            args << "AMmapGet(m_document, get_object_id, AMstr(\"" << key << "\"), nullptr) == \"" << property
-                 << "\", \"" << value << "\"";
+void Node::check_string_property(Property const& property, std::string const& value) const {
+    detail::Arguments args;
+    AMitem const* const item = find_property(property);
+    AMbyteSpan str;
+    if (!(item && AMitemToStr(item, &str) && utils::from_bytes(str) == value)) {
+        // The property may still be a matching text object.
+        try {
+            auto const string = get_object_property<String>(property);
+            if (string != value) {
+                args << "AMmapGet(m_document, get_object_id, AMstr(\"" << property.key << "\"), nullptr) == \""
+                     << string << "\", \"" << value << "\"";
+            }
+        } catch (std::invalid_argument const& thrown) {
+            args << thrown.what();
         }
-    } catch (std::invalid_argument const& thrown) {
-        args << thrown.what();
     }
-    // Free the AMresult because we're finished with it.
-    m_results.erase(key);
-    if (!args.str().empty()) {
+    release_property(property);
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
     }
 }
 
+template <typename EnumT>
+std::optional<EnumT> Node::find_enum_property(Property const& property) const {
+    return extract_item_tag<EnumT>(m_document, find_property(property));
+}
+
+AMitem const* Node::find_property(Property const& property) const {
+    assert(property.slot < m_items.size());
+    auto& item = m_items[property.slot];
+    if (!item) {
+        auto const& result = store_property(property);
+        // Serve later reads from the slot, as if it had been materialized.
+        item = (result) ? AMresultItem(result.get()) : nullptr;
+    }
+    return item;
+}
+
 template <typename InputRangeT>
-InputRangeT Node::get_array_property(std::string const& key) const {
-    ResultPtr const result{AMmapGet(m_document, get_object_id(), utils::to_bytes(key), nullptr), AMresultFree};
-    auto [iter, inserted] = m_results.insert_or_assign(key, result);
-    return InputRangeT{m_document, AMresultItem(iter->second.get())};
+InputRangeT Node::get_array_property(Property const& property) const {
+    return InputRangeT{m_document, find_property(property)};
 }
 
 template <typename EnumT>
-EnumT Node::get_enum_property(std::string const& key) const {
-    ResultPtr const result{AMmapGet(m_document, get_object_id(), utils::to_bytes(key), nullptr), AMresultFree};
+EnumT Node::get_enum_property(Property const& property) const {
+    auto const tag = find_enum_property<EnumT>(property);
+    if (tag) {
+        return *tag;
+    }
+    // Describe the failure only now that it's certain.
     std::ostringstream args;
-    if (!result) {
-        args << "AMmapGet(m_document, ..., AMstr(\"" << key << "\"), nullptr) == nullptr";
+    AMitem const* const item = find_property(property);
+    if (!item) {
+        args << "AMmapGet(m_document, ..., AMstr(\"" << property.key << "\"), nullptr) == nullptr";
     } else {
-        auto [iter, inserted] = m_results.insert_or_assign(key, result);
         try {
-            String string{m_document, AMresultItem(iter->second.get())};
-            EnumT tag;
-            auto const buffer = std::string{string};
-            std::istringstream iss{buffer};
-            if (iss >> tag) {
-                return tag;
-            } else {
-                args << "AMmapGet(m_document, ..., AMstr(\"" << key << "\"), nullptr) == \"" << string << "\"";
-            }
+            String string{m_document, item};
+            args << "AMmapGet(m_document, ..., AMstr(\"" << property.key << "\"), nullptr) == \"" << string << "\"";
         } catch (std::invalid_argument const& thrown) {
             args << thrown.what();
         }
     }
-    if (!args.str().empty()) {
-        std::ostringstream what;
-        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
-        throw std::invalid_argument(what.str());
-    }
-    return EnumT{};
+    std::ostringstream what;
+    what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
+    throw std::invalid_argument(what.str());
 }
 
 template <typename EnumT>
-std::optional<EnumT> Node::get_nullable_enum_property(std::string const& key) const {
-    std::optional<EnumT> nullable_enum;
-    try {
-        nullable_enum.emplace(get_enum_property<EnumT>(key));
-    } catch (std::invalid_argument const&) {
-        if (AMitemValType(AMresultItem(m_results.at(key).get())) != AM_VAL_TYPE_NULL) {
-            throw;
-        }
+std::optional<EnumT> Node::get_nullable_enum_property(Property const& property) const {
+    AMitem const* const item = find_property(property);
+    auto const tag = extract_item_tag<EnumT>(m_document, item);
+    if (tag || (item && AMitemValType(item) == AM_VAL_TYPE_NULL)) {
+        return tag;
     }
-    return nullable_enum;
+    // Report that it's neither a tag nor null.
+    return get_enum_property<EnumT>(property);
 }
 
 template <typename ObjectT>
-std::optional<ObjectT> Node::get_nullable_object_property(std::string const& key) const {
-    std::optional<ObjectT> nullable_object;
-    try {
-        nullable_object.emplace(get_object_property<ObjectT>(key));
-    } catch (std::invalid_argument const&) {
-        if (AMitemValType(AMresultItem(m_results.at(key).get())) != AM_VAL_TYPE_NULL) {
-            throw;
-        }
+std::optional<ObjectT> Node::get_nullable_object_property(Property const& property) const {
+    AMitem const* const item = find_property(property);
+    if (item && AMitemValType(item) == AM_VAL_TYPE_NULL) {
+        return std::nullopt;
     }
-    return nullable_object;
+    return to_object<ObjectT>(item);
+}
+
+std::uint64_t Node::get_fetch_count() {
+    return fetch_count.load(std::memory_order_relaxed);
 }
 
 AMobjId const* Node::get_object_id() const {
-    return AMitemObjId(AMresultItem(m_results.at("").get()));
+    return AMitemObjId(AMresultItem(m_map_object.get()));
+}
+
+template <typename ObjectT>
+ObjectT Node::get_object_property(Property const& property) const {
+    return to_object<ObjectT>(find_property(property));
+}
+
+void Node::materialize() const {
+    // One call for the map object's items instead of one for each of them.
+    ResultPtr const result = utils::ResultArena::adopt(AMobjItems(m_document, get_object_id(), nullptr), m_arena);
+    fetch_count.fetch_add(1, std::memory_order_relaxed);
+    if (!result || AMresultStatus(result.get()) != AM_STATUS_OK) {
+        return;
+    }
+    AMitems items = AMresultItems(result.get());
+    for (AMitem* item = AMitemsNext(&items, 1); item; item = AMitemsNext(&items, 1)) {
+        AMbyteSpan key;
+        if (!AMitemKey(item, &key)) {
+            continue;
+        }
+        auto const view = utils::from_bytes(key);
+        for (auto const& property : m_properties) {
+            if (property.key == view) {
+                m_results[property.slot] = result;
+                m_items[property.slot] = item;
+                break;
+            }
+        }
+    }
+}
+
+void Node::release_property(Property const& property) const {
+    assert(property.slot < m_results.size());
+    // The node's arena owns the AMresult until it ends, so releasing it
+    // wouldn't free it and a later read would only get the property again.
+    if (!m_arena) {
+        m_results[property.slot].reset();
+        m_items[property.slot] = nullptr;
+    }
+}
+
+void Node::reuse_property(Property const& property, ResultPtr const& result) const {
+    assert(property.slot < m_results.size());
+    if (result) {
+        m_results[property.slot] = result;
+        m_items[property.slot] = AMresultItem(result.get());
+    }
+}
+
+Node::ResultPtr const& Node::store_property(Property const& property) const {
+    assert(property.slot < m_results.size());
+    auto& result = m_results[property.slot];
+    result = utils::ResultArena::adopt(
+        AMmapGet(m_document, get_object_id(), utils::to_bytes(property.key), nullptr), m_arena);
+    fetch_count.fetch_add(1, std::memory_order_relaxed);
+    return result;
 }
 
 template <typename ObjectT>
-ObjectT Node::get_object_property(std::string const& key) const {
-    ResultPtr const result{AMmapGet(m_document, get_object_id(), utils::to_bytes(key), nullptr), AMresultFree};
-    auto [iter, inserted] = m_results.insert_or_assign(key, result);
+ObjectT Node::to_object(AMitem const* const item) const {
     try {
-        return ObjectT{m_document, AMresultItem(iter->second.get())};
+        return ObjectT{m_document, item};
     } catch (std::invalid_argument const& thrown) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << thrown.what() << ")";
@@ -234,65 +387,78 @@ ObjectT Node::get_object_property(std::string const& key) const {
 }
 
 // Node::check_enum_property()
-template void Node::check_enum_property<AssignmentType>(std::string const&, AssignmentType const) const;
+template void Node::check_enum_property<AssignmentType>(Property const&, AssignmentType const) const;
+
+template void Node::check_enum_property<StatementType>(Property const&, StatementType const) const;
+
+template void Node::check_enum_property<ValueType>(Property const&, ValueType const) const;
+
+// Node::find_enum_property()
+template std::optional<AssignmentKeyword> Node::find_enum_property<AssignmentKeyword>(Property const&) const;
+
+template std::optional<AssignmentType> Node::find_enum_property<AssignmentType>(Property const&) const;
+
+template std::optional<DeclarationKeyword> Node::find_enum_property<DeclarationKeyword>(Property const&) const;
+
+template std::optional<DefinitionType> Node::find_enum_property<DefinitionType>(Property const&) const;
 
-template void Node::check_enum_property<StatementType>(std::string const&, StatementType const) const;
+template std::optional<StatementType> Node::find_enum_property<StatementType>(Property const&) const;
 
-template void Node::check_enum_property<ValueType>(std::string const&, ValueType const) const;
+template std::optional<ValueType> Node::find_enum_property<ValueType>(Property const&) const;
 
 // Node::get_array_property()
 template ClassDefinition::ClassDeclarations Node::get_array_property<ClassDefinition::ClassDeclarations>(
-    std::string const&) const;
+    Property const&) const;
 
-template Definition::Statements Node::get_array_property<Definition::Statements>(std::string const&) const;
+template Definition::Statements Node::get_array_property<Definition::Statements>(Property const&) const;
 
-template Descriptor::Assignments Node::get_array_property<Descriptor::Assignments>(std::string const&) const;
+template Descriptor::Assignments Node::get_array_property<Descriptor::Assignments>(Property const&) const;
 
-template File::Statements Node::get_array_property<File::Statements>(std::string const&) const;
+template File::Statements Node::get_array_property<File::Statements>(Property const&) const;
 
 template ObjectDeclarationEntries::Values Node::get_array_property<ObjectDeclarationEntries::Values>(
-    std::string const&) const;
+    Property const&) const;
 
 template ObjectDeclarationList::Values Node::get_array_property<ObjectDeclarationList::Values>(
-    std::string const&) const;
+    Property const&) const;
 
 template VariantDefinition::Definitions Node::get_array_property<VariantDefinition::Definitions>(
-    std::string const&) const;
+    Property const&) const;
 
 template VariantSet::VariantDefinitions Node::get_array_property<VariantSet::VariantDefinitions>(
-    std::string const&) const;
+    Property const&) const;
 
 // Node::get_enum_property()
-template AssignmentKeyword Node::get_enum_property<AssignmentKeyword>(std::string const&) const;
+template AssignmentKeyword Node::get_enum_property<AssignmentKeyword>(Property const&) const;
 
-template DeclarationKeyword Node::get_enum_property<DeclarationKeyword>(std::string const&) const;
+template DeclarationKeyword Node::get_enum_property<DeclarationKeyword>(Property const&) const;
 
-template DefinitionType Node::get_enum_property<DefinitionType>(std::string const&) const;
+template DefinitionType Node::get_enum_property<DefinitionType>(Property const&) const;
 
 // Node::get_nullable_enum_property()
-template std::optional<AssignmentKeyword> Node::get_nullable_enum_property<AssignmentKeyword>(std::string const&) const;
+template std::optional<AssignmentKeyword> Node::get_nullable_enum_property<AssignmentKeyword>(Property const&) const;
 
 template std::optional<DeclarationKeyword> Node::get_nullable_enum_property<DeclarationKeyword>(
-    std::string const&) const;
+    Property const&) const;
 
 // Node::get_nullable_object_property()
-template std::optional<Descriptor> Node::get_nullable_object_property<Descriptor>(std::string const&) const;
+template std::optional<Descriptor> Node::get_nullable_object_property<Descriptor>(Property const&) const;
 
 template std::optional<ExternalReferenceImport> Node::get_nullable_object_property<ExternalReferenceImport>(
-    std::string const&) const;
+    Property const&) const;
 
-template std::optional<String> Node::get_nullable_object_property<String>(std::string const&) const;
+template std::optional<String> Node::get_nullable_object_property<String>(Property const&) const;
 
 // Node::get_object_property()
-template Number Node::get_object_property<Number>(std::string const&) const;
+template Number Node::get_object_property<Number>(Property const&) const;
 
-template ObjectDeclarations Node::get_object_property<ObjectDeclarations>(std::string const&) const;
+template ObjectDeclarations Node::get_object_property<ObjectDeclarations>(Property const&) const;
 
-template String Node::get_object_property<String>(std::string const&) const;
+template String Node::get_object_property<String>(Property const&) const;
 
-template ReferenceFile Node::get_object_property<ReferenceFile>(std::string const&) const;
+template ReferenceFile Node::get_object_property<ReferenceFile>(Property const&) const;
 
-template Value Node::get_object_property<Value>(std::string const&) const;
+template Value Node::get_object_property<Value>(Property const&) const;
 
 }  // namespace usdj_am
 }  // namespace cavi
@@ -40,13 +40,14 @@ extern "C" {
 }
 
 // local
+#include "detail/arguments.hpp"
 #include "number.hpp"
 
 namespace cavi {
 namespace usdj_am {
 
 Number::Number(AMdoc const* const document, AMitem const* const item) {
-    std::ostringstream args;
+    detail::Arguments args;
     AMvalType const val_type = AMitemValType(item);
     switch (val_type) {
         case AM_VAL_TYPE_F64: {
@@ -81,7 +82,7 @@ Number::Number(AMdoc const* const document, AMitem const* const item) {
             break;
         }
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
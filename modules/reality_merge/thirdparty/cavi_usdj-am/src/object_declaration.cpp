@@ -27,15 +27,35 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "object_declaration.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property DEFINE_TYPE{0, "defineType"};
+constexpr Node::Property KEYWORD{1, "keyword"};
+constexpr Node::Property REFERENCE{2, "reference"};
+constexpr Node::Property VALUE{3, "value"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 4> ALL = {DEFINE_TYPE, KEYWORD, REFERENCE, VALUE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 ObjectDeclaration::ObjectDeclaration(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 4) {}
+    : Node(document, map_object, property::ALL) {}
 
 void ObjectDeclaration::accept(Visitor& visitor) const& {
     visitor.visit(*this);
@@ -46,19 +66,19 @@ void ObjectDeclaration::accept(Visitor& visitor) && {
 }
 
 TypeReference ObjectDeclaration::get_define_type() const {
-    return get_object_property<String>("defineType");
+    return get_object_property<String>(property::DEFINE_TYPE);
 }
 
 std::optional<DeclarationKeyword> ObjectDeclaration::get_keyword() const {
-    return get_nullable_enum_property<DeclarationKeyword>("keyword");
+    return get_nullable_enum_property<DeclarationKeyword>(property::KEYWORD);
 }
 
 Reference ObjectDeclaration::get_reference() const {
-    return get_object_property<String>("reference");
+    return get_object_property<String>(property::REFERENCE);
 }
 
 Value ObjectDeclaration::get_value() const {
-    return get_object_property<Value>("value");
+    return get_object_property<Value>(property::VALUE);
 }
 
 }  // namespace usdj_am
@@ -27,16 +27,34 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "object_declaration_entries.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property TYPE{0, "type"};
+constexpr Node::Property VALUES{1, "values"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 2> ALL = {TYPE, VALUES};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 ObjectDeclarationEntries::ObjectDeclarationEntries(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 2) {
-    check_string_property("type", "objectDeclarationEntries");
+    : Node(document, map_object, property::ALL) {
+    check_string_property(property::TYPE, "objectDeclarationEntries");
 }
 
 void ObjectDeclarationEntries::accept(Visitor& visitor) const& {
@@ -48,11 +66,11 @@ void ObjectDeclarationEntries::accept(Visitor& visitor) && {
 }
 
 String ObjectDeclarationEntries::get_type() const {
-    return get_object_property<String>("type");
+    return get_object_property<String>(property::TYPE);
 }
 
 ObjectDeclarationEntries::Values ObjectDeclarationEntries::get_values() const {
-    return get_array_property<Values>("values");
+    return get_array_property<Values>(property::VALUES);
 }
 
 }  // namespace usdj_am
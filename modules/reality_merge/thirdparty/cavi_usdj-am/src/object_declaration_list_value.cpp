@@ -27,15 +27,33 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "object_declaration_list_value.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property INDEX{0, "index"};
+constexpr Node::Property VALUE{1, "value"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 2> ALL = {INDEX, VALUE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 ObjectDeclarationListValue::ObjectDeclarationListValue(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 2) {}
+    : Node(document, map_object, property::ALL) {}
 
 void ObjectDeclarationListValue::accept(Visitor& visitor) const& {
     visitor.visit(*this);
@@ -46,11 +64,11 @@ void ObjectDeclarationListValue::accept(Visitor& visitor) && {
 }
 
 Number ObjectDeclarationListValue::get_index() const {
-    return get_object_property<Number>("index");
+    return get_object_property<Number>(property::INDEX);
 }
 
 Value ObjectDeclarationListValue::get_value() const {
-    return get_object_property<Value>("value");
+    return get_object_property<Value>(property::VALUE);
 }
 
 }  // namespace usdj_am
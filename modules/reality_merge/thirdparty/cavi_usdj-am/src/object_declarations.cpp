@@ -28,8 +28,10 @@
 /**************************************************************************/
 
 #include <cstddef>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
 #include <typeinfo>
 
 // third-party
@@ -39,6 +41,8 @@ extern "C" {
 }
 
 // local
+#include "detail/arguments.hpp"
+#include "detail/map_type.hpp"
 #include "object_declarations.hpp"
 #include "visitor.hpp"
 
@@ -48,8 +52,20 @@ namespace usdj_am {
 ObjectDeclarations::ObjectDeclarations(AMdoc const* const document, AMitem const* const map_object) {
     enum { BEGIN__, LIST = BEGIN__, ENTRIES, END__, SIZE__ = END__ - BEGIN__ };
 
-    std::ostringstream args;
+    // Only try the alternative named by the map object's type, if any.
+    auto const type =
+        detail::extract_map_type(document, map_object, [](std::string_view const& view) -> std::optional<std::size_t> {
+            if (view == "objectDeclarationList") {
+                return LIST;
+            } else if (view == "objectDeclarationEntries") {
+                return ENTRIES;
+            }
+            return std::nullopt;
+        });
+    detail::Arguments args;
     for (std::size_t index = BEGIN__; index != END__; ++index) {
+        if (type && index != *type)
+            continue;
         try {
             switch (index) {
                 case LIST: {
@@ -61,16 +77,16 @@ ObjectDeclarations::ObjectDeclarations(AMdoc const* const document, AMitem const
                     break;
                 }
             }
-            args.str("");
+            args.clear();
             break;
         } catch (std::invalid_argument const& thrown) {
-            if (!args.str().empty()) {
+            if (args) {
                 args << " | ";
             }
             args << thrown.what();
         }
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
@@ -27,15 +27,34 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "object_value.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property DECLARATIONS{0, "declarations"};
+constexpr Node::Property TYPE{1, "type"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 2> ALL = {DECLARATIONS, TYPE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
-ObjectValue::ObjectValue(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 2) {
-    check_enum_property("type", ValueType::OBJECT_VALUE);
+ObjectValue::ObjectValue(AMdoc const* const document, AMitem const* const map_object)
+    : Node(document, map_object, property::ALL) {
+    check_enum_property(property::TYPE, ValueType::OBJECT_VALUE);
 }
 
 void ObjectValue::accept(Visitor& visitor) const& {
@@ -47,7 +66,7 @@ void ObjectValue::accept(Visitor& visitor) && {
 }
 
 ObjectDeclarations ObjectValue::get_declarations() const {
-    return get_object_property<ObjectDeclarations>("declarations");
+    return get_object_property<ObjectDeclarations>(property::DECLARATIONS);
 }
 
 }  // namespace usdj_am
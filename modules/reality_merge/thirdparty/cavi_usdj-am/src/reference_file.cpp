@@ -27,17 +27,36 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "reference_file.hpp"
 #include "descriptor.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property DESCRIPTOR{0, "descriptor"};
+constexpr Node::Property SRC{1, "src"};
+constexpr Node::Property TYPE{2, "type"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 3> ALL = {DESCRIPTOR, SRC, TYPE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 ReferenceFile::ReferenceFile(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 3) {
-    check_enum_property("type", ValueType::EXTERNAL_REFERENCE_SRC);
+    : Node(document, map_object, property::ALL) {
+    check_enum_property(property::TYPE, ValueType::EXTERNAL_REFERENCE_SRC);
 }
 
 void ReferenceFile::accept(Visitor& visitor) const& {
@@ -49,11 +68,11 @@ void ReferenceFile::accept(Visitor& visitor) && {
 }
 
 std::optional<Descriptor> ReferenceFile::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(property::DESCRIPTOR);
 }
 
 String ReferenceFile::get_src() const {
-    return get_object_property<String>("src");
+    return get_object_property<String>(property::SRC);
 }
 
 }  // namespace usdj_am
@@ -1,5 +1,5 @@
 /**************************************************************************/
-/* usdj_color_extractor.h                                                 */
+/* scene_change.cpp                                                       */
 /**************************************************************************/
 /*                         This file is part of:                          */
 /*                             RealityMerge                               */
@@ -27,49 +27,41 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#ifndef REALITY_MERGE_USDJ_COLOR_EXTRACTOR_H
-#define REALITY_MERGE_USDJ_COLOR_EXTRACTOR_H
-
-#include <cstdint>
+#include <iostream>
 #include <map>
-#include <memory>
-
-// third-party
-#include <cavi/usdj_am/visitor.hpp>
-
-struct Color;
-
-/// \brief An extractor of a color value embedded within a "USDA_Definition"
-///        node.
-class UsdjColorExtractor : public cavi::usdj_am::Visitor {
-public:
-    UsdjColorExtractor() = delete;
-
-    UsdjColorExtractor(cavi::usdj_am::Definition const& p_definition);
-
-    UsdjColorExtractor(UsdjColorExtractor const&) = delete;
+#include <string_view>
 
-    UsdjColorExtractor(UsdjColorExtractor&&) = default;
+// local
+#include "scene_change.hpp"
 
-    ~UsdjColorExtractor();
+namespace {
 
-    UsdjColorExtractor& operator=(UsdjColorExtractor const&) = delete;
+using cavi::usdj_am::SceneChangeType;
 
-    UsdjColorExtractor& operator=(UsdjColorExtractor&&) = default;
-
-    std::optional<Color> operator()();
-
-    void visit(cavi::usdj_am::Declaration const& declaration) override;
-
-    void visit(cavi::usdj_am::Definition const& definition) override;
+static std::map<std::string_view, SceneChangeType> const TAGS = {
+    {"declarationChanged", SceneChangeType::DECLARATION_CHANGED},
+    {"definitionChanged", SceneChangeType::DEFINITION_CHANGED},
+    {"descriptorChanged", SceneChangeType::DESCRIPTOR_CHANGED},
+    {"primAdded", SceneChangeType::PRIM_ADDED},
+    {"primRemoved", SceneChangeType::PRIM_REMOVED},
+    {"xformOpOrderChanged", SceneChangeType::XFORM_OP_ORDER_CHANGED},
+};
 
-    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
+}  // namespace
 
-private:
-    enum class Component : std::uint8_t { BEGIN__ = 1, R = BEGIN__, G, B, A, END__, SIZE__ = END__ - BEGIN__ };
+namespace cavi {
+namespace usdj_am {
 
-    cavi::usdj_am::Definition const& m_definition;
-    std::map<Component, float> m_components;
-};
+std::ostream& operator<<(std::ostream& os, SceneChangeType const& in) {
+    for (auto item : TAGS) {
+        if (item.second == in) {
+            os << item.first;
+            return os;
+        }
+    }
+    os << "???";
+    return os;
+}
 
-#endif  // REALITY_MERGE_USDJ_COLOR_EXTRACTOR_H
+}  // namespace usdj_am
+}  // namespace cavi
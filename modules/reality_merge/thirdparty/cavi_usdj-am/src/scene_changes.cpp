@@ -0,0 +1,179 @@
+/**************************************************************************/
+/* scene_index.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// local
+#include "scene_changes.hpp"
+#include "utils/operations.hpp"
+
+namespace cavi {
+namespace usdj_am {
+
+SceneChanges::SceneChanges(SceneIndex& index, utils::Operations const& operations, AMitems const* const after_heads) {
+    using Action = utils::Operations::Action;
+    using Role = SceneIndex::Role;
+
+    // Index the objects that were made within the tree before classifying the
+    // operations so that the statements' types are known.
+    std::vector<std::pair<utils::Operations::Operation const*, SceneIndex::Entry>> applied;
+    std::unordered_map<AMobjId const*, std::unordered_set<std::string>> added_statements;
+    for (auto const& operation : operations) {
+        auto const entry = index.find(operation.object);
+        if (!entry)
+            continue;
+        applied.emplace_back(&operation, *entry);
+        if (!operation.makes_object())
+            continue;
+        auto child = *entry;
+        switch (entry->role) {
+            case Role::DEFINITION: {
+                child.role = (operation.key == "descriptor")   ? Role::DESCRIPTOR
+                             : (operation.key == "statements") ? Role::STATEMENTS
+                                                               : Role::PROPERTY;
+                break;
+            }
+            case Role::STATEMENTS: {
+                child.role = Role::STATEMENT;
+                child.statement = &index.insert_statement(operation.id);
+                added_statements[entry->owner].insert(operation.id);
+                break;
+            }
+            case Role::STATEMENT: {
+                child.role = Role::STATEMENT_PROPERTY;
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+        index.insert(operation.id, child);
+    }
+    for (auto const& statements : added_statements) {
+        index.resolve_statements(statements.first, statements.second, after_heads);
+    }
+    for (auto const& pair : applied) {
+        auto const& operation = pair.first;
+        auto const& entry = pair.second;
+        switch (entry.role) {
+            case Role::DEFINITION: {
+                if (operation->key == "descriptor") {
+                    push_back({SceneChangeType::DESCRIPTOR_CHANGED, entry.owner, std::nullopt});
+                } else if (operation->key == "statements") {
+                    // The entire array of statements was replaced.
+                    push_back({SceneChangeType::PRIM_REMOVED, entry.owner, std::nullopt});
+                    push_back({SceneChangeType::PRIM_ADDED, entry.owner, std::nullopt});
+                } else {
+                    push_back({SceneChangeType::DEFINITION_CHANGED, entry.owner, std::nullopt});
+                }
+                break;
+            }
+            case Role::DESCRIPTOR: {
+                push_back({SceneChangeType::DESCRIPTOR_CHANGED, entry.owner, std::nullopt});
+                break;
+            }
+            case Role::STATEMENTS: {
+                // A statement keeps its object ID in every version so one that
+                // was overwritten or deleted is identified by its predecessor.
+                for (auto const& predecessor : operation->predecessors) {
+                    auto const removed = index.find(predecessor);
+                    if (removed && removed->role == Role::DEFINITION) {
+                        push_back({SceneChangeType::PRIM_REMOVED, entry.owner, std::nullopt});
+                    } else {
+                        push_statement(entry.owner, index.find_statement(predecessor), SceneChangeType::PRIM_REMOVED);
+                    }
+                }
+                if (operation->makes_object()) {
+                    push_statement(entry.owner, index.find_statement(operation->id), SceneChangeType::PRIM_ADDED);
+                } else if (operation->action != Action::DEL) {
+                    push_back({SceneChangeType::DEFINITION_CHANGED, entry.owner, std::nullopt});
+                }
+                break;
+            }
+            case Role::STATEMENT: {
+                if (operation->key == "type" || operation->key == "reference") {
+                    // The statement's kind or identity was changed.
+                    push_back({SceneChangeType::DEFINITION_CHANGED, entry.owner, std::nullopt});
+                } else {
+                    push_statement(entry.owner, entry.statement, SceneChangeType::DEFINITION_CHANGED);
+                }
+                break;
+            }
+            case Role::STATEMENT_PROPERTY: {
+                push_statement(entry.owner, entry.statement, SceneChangeType::DEFINITION_CHANGED);
+                break;
+            }
+            case Role::PROPERTY: {
+                push_back({SceneChangeType::DEFINITION_CHANGED, entry.owner, std::nullopt});
+                break;
+            }
+        }
+    }
+}
+
+SceneChanges::~SceneChanges() {}
+
+void SceneChanges::push_statement(AMobjId const* const owner_id,
+                                  SceneIndex::Statement const* const statement,
+                                  SceneChangeType const definition_type) {
+    auto const type = statement ? statement->type : std::nullopt;
+    if (type == StatementType::DEFINITION) {
+        push_back({definition_type, owner_id, std::nullopt});
+    } else if (type == StatementType::DECLARATION) {
+        auto const& identifier = statement->identifier;
+        auto const change_type = (identifier == "xformOpOrder") ? SceneChangeType::XFORM_OP_ORDER_CHANGED
+                                                                : SceneChangeType::DECLARATION_CHANGED;
+        push_back({change_type, owner_id, identifier});
+    } else {
+        push_back({SceneChangeType::DEFINITION_CHANGED, owner_id, std::nullopt});
+    }
+}
+
+void SceneChanges::push_back(SceneChange&& change) {
+    if (!m_changes.empty()) {
+        auto const& last = m_changes.back();
+        if (last.type == change.type && AMobjIdEqual(last.object_id, change.object_id) &&
+            last.identifier == change.identifier)
+            return;
+    }
+    m_changes.push_back(std::move(change));
+}
+
+}  // namespace usdj_am
+}  // namespace cavi
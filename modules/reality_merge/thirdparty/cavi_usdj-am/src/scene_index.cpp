@@ -0,0 +1,266 @@
+/**************************************************************************/
+/* scene_index.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <typeinfo>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// local
+#include "scene_index.hpp"
+#include "string_.hpp"
+#include "utils/bytes.hpp"
+#include "utils/operations.hpp"
+
+namespace {
+
+using cavi::usdj_am::SceneIndex;
+using cavi::usdj_am::StatementType;
+
+using ResultPtr = std::shared_ptr<AMresult>;
+
+/// \brief Indexes the items of a map object by their keys.
+std::map<std::string_view, AMitem const*> to_properties(AMresult* const result) {
+    using cavi::usdj_am::utils::from_bytes;
+
+    std::map<std::string_view, AMitem const*> properties;
+    AMitems items = AMresultItems(result);
+    AMitem* item = nullptr;
+    while ((item = AMitemsNext(&items, 1)) != nullptr) {
+        AMbyteSpan key;
+        if (AMitemKey(item, &key))
+            properties.emplace(from_bytes(key), item);
+    }
+    return properties;
+}
+
+/// \brief Gets a string property out of the items of a map object.
+///
+/// \returns The string or `std::nullopt` if there isn't one.
+std::optional<std::string> get_string(AMdoc const* const document,
+                                      std::map<std::string_view, AMitem const*> const& properties,
+                                      std::string_view const& key) {
+    auto const match = properties.find(key);
+    if (match != properties.end()) {
+        try {
+            return std::string{cavi::usdj_am::String{document, match->second}};
+        } catch (std::invalid_argument const&) {
+            // It isn't a string.
+        }
+    }
+    return std::nullopt;
+}
+
+/// \brief Reads what's known about a statement out of the items of its map
+///        object.
+SceneIndex::Statement read_statement(AMdoc const* const document,
+                                     std::map<std::string_view, AMitem const*> const& properties) {
+    SceneIndex::Statement statement{};
+    if (auto const type = get_string(document, properties, "type")) {
+        std::istringstream iss{*type};
+        StatementType tag;
+        if (iss >> tag)
+            statement.type = tag;
+    }
+    if (statement.type == StatementType::DECLARATION)
+        statement.identifier = get_string(document, properties, "reference");
+    return statement;
+}
+
+/// \returns `true` if an item holds an object that may contain others.
+bool is_container(AMdoc const* const document, AMitem const* const item) {
+    // A text object only contains characters.
+    return AMitemValType(item) == AM_VAL_TYPE_OBJ_TYPE &&
+           AMobjObjType(document, AMitemObjId(item)) != AM_OBJ_TYPE_TEXT;
+}
+
+}  // namespace
+
+namespace cavi {
+namespace usdj_am {
+
+SceneIndex::SceneIndex(AMdoc* const document, AMitem const* const file_item)
+    : m_document{document}, m_file_object{nullptr, AMresultFree} {
+    std::ostringstream args;
+    if (!document) {
+        args << "document == nullptr, ...";
+    } else if (!file_item) {
+        args << "..., file_item == nullptr";
+    } else if (AMitemValType(file_item) != AM_VAL_TYPE_OBJ_TYPE) {
+        args << "..., AMitemValType(file_item) != AM_VAL_TYPE_OBJ_TYPE";
+    } else {
+        // Preserve the AMitem storing the node's object ID.
+        m_file_object = ResultPtr{AMitemResult(file_item), AMresultFree};
+        index_definition(get_file_object_id());
+    }
+    if (!args.str().empty()) {
+        std::ostringstream what;
+        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
+        throw std::invalid_argument(what.str());
+    }
+}
+
+SceneIndex::~SceneIndex() {}
+
+SceneIndex::Entry const* SceneIndex::find(std::string const& key) const {
+    auto const match = m_entries.find(key);
+    return (match != m_entries.end()) ? &match->second : nullptr;
+}
+
+SceneIndex::Statement* SceneIndex::find_statement(std::string const& key) {
+    auto const match = m_statements.find(key);
+    return (match != m_statements.end()) ? &match->second : nullptr;
+}
+
+AMobjId const* SceneIndex::get_file_object_id() const {
+    return AMitemObjId(AMresultItem(m_file_object.get()));
+}
+
+void SceneIndex::insert(std::string const& key, Entry const& entry) {
+    m_entries.insert_or_assign(key, entry);
+}
+
+SceneIndex::Statement& SceneIndex::insert_statement(std::string const& key) {
+    return m_statements[key] = Statement{};
+}
+
+bool SceneIndex::is_changed(utils::Operations const& operations) const {
+    // An object that was made within the tree was made by an operation on an
+    // object that was already within it.
+    for (auto const& operation : operations) {
+        if (m_entries.count(operation.object))
+            return true;
+    }
+    return false;
+}
+
+void SceneIndex::resolve_statements(AMobjId const* const owner,
+                                    std::unordered_set<std::string> const& keys,
+                                    AMitems const* const heads) {
+    ResultPtr const result{AMmapGet(m_document, owner, utils::to_bytes("statements"), heads), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK || !is_container(m_document, AMresultItem(result.get())))
+        return;
+    ResultPtr const list_result{AMobjItems(m_document, AMitemObjId(AMresultItem(result.get())), heads),
+                                AMresultFree};
+    if (AMresultStatus(list_result.get()) != AM_STATUS_OK)
+        return;
+    AMitems items = AMresultItems(list_result.get());
+    AMitem* item = nullptr;
+    while ((item = AMitemsNext(&items, 1)) != nullptr) {
+        if (AMitemValType(item) != AM_VAL_TYPE_OBJ_TYPE)
+            continue;
+        AMobjId const* const statement_id = AMitemObjId(item);
+        auto const key = utils::Operations::make_key(statement_id);
+        auto const match = m_statements.find(key);
+        if (!keys.count(key) || match == m_statements.end())
+            continue;
+        ResultPtr const statement_result{AMobjItems(m_document, statement_id, heads), AMresultFree};
+        if (AMresultStatus(statement_result.get()) == AM_STATUS_OK)
+            match->second = read_statement(m_document, to_properties(statement_result.get()));
+    }
+}
+
+void SceneIndex::index_definition(AMobjId const* const object_id) {
+    m_entries.insert_or_assign(utils::Operations::make_key(object_id), Entry{Role::DEFINITION, object_id, nullptr});
+    ResultPtr const result{AMobjItems(m_document, object_id, nullptr), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK)
+        return;
+    for (auto const& property : to_properties(result.get())) {
+        if (!is_container(m_document, property.second))
+            continue;
+        AMobjId const* const child_id = AMitemObjId(property.second);
+        if (property.first == "descriptor") {
+            index_object(child_id, Entry{Role::DESCRIPTOR, object_id, nullptr});
+        } else if (property.first == "statements") {
+            index_statements(child_id, object_id);
+        } else {
+            index_object(child_id, Entry{Role::PROPERTY, object_id, nullptr});
+        }
+    }
+}
+
+void SceneIndex::index_statements(AMobjId const* const object_id, AMobjId const* const owner) {
+    m_entries.insert_or_assign(utils::Operations::make_key(object_id), Entry{Role::STATEMENTS, owner, nullptr});
+    ResultPtr const result{AMobjItems(m_document, object_id, nullptr), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK)
+        return;
+    // Preserve the object IDs of the statements that are nodes of their own.
+    m_results.push_back(result);
+    AMitems items = AMresultItems(result.get());
+    AMitem* item = nullptr;
+    while ((item = AMitemsNext(&items, 1)) != nullptr) {
+        if (!is_container(m_document, item))
+            continue;
+        AMobjId const* const statement_id = AMitemObjId(item);
+        ResultPtr const statement_result{AMobjItems(m_document, statement_id, nullptr), AMresultFree};
+        if (AMresultStatus(statement_result.get()) != AM_STATUS_OK)
+            continue;
+        auto const properties = to_properties(statement_result.get());
+        auto statement = read_statement(m_document, properties);
+        if (statement.type == StatementType::DEFINITION) {
+            index_definition(statement_id);
+            continue;
+        }
+        auto const key = utils::Operations::make_key(statement_id);
+        auto const& indexed = (m_statements[key] = std::move(statement));
+        m_entries.insert_or_assign(key, Entry{Role::STATEMENT, owner, &indexed});
+        for (auto const& property : properties) {
+            if (is_container(m_document, property.second))
+                index_object(AMitemObjId(property.second), Entry{Role::STATEMENT_PROPERTY, owner, &indexed});
+        }
+    }
+}
+
+void SceneIndex::index_object(AMobjId const* const object_id, Entry const& entry) {
+    m_entries.insert_or_assign(utils::Operations::make_key(object_id), entry);
+    ResultPtr const result{AMobjItems(m_document, object_id, nullptr), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK)
+        return;
+    AMitems items = AMresultItems(result.get());
+    AMitem* item = nullptr;
+    while ((item = AMitemsNext(&items, 1)) != nullptr) {
+        if (AMitemValType(item) != AM_VAL_TYPE_OBJ_TYPE)
+            continue;
+        if (is_container(m_document, item)) {
+            index_object(AMitemObjId(item), entry);
+        } else {
+            m_entries.insert_or_assign(utils::Operations::make_key(AMitemObjId(item)), entry);
+        }
+    }
+}
+
+}  // namespace usdj_am
+}  // namespace cavi
@@ -28,6 +28,8 @@
 /**************************************************************************/
 
 #include <functional>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
@@ -41,6 +43,8 @@ extern "C" {
 }
 
 // local
+#include "detail/arguments.hpp"
+#include "detail/map_type.hpp"
 #include "statement.hpp"
 #include "statement_type.hpp"
 #include "visitor.hpp"
@@ -48,39 +52,36 @@ extern "C" {
 namespace cavi {
 namespace usdj_am {
 
-Statement::Statement(AMdoc const* const document, AMitem const* const map_object) {
-    using Index = typename std::underlying_type<StatementType>::type;
-
-    std::ostringstream args;
-    for (Index index = static_cast<Index>(StatementType::BEGIN__); index != static_cast<Index>(StatementType::END__);
-         ++index) {
-        try {
-            switch (static_cast<StatementType>(index)) {
-                case StatementType::CLASS_DEFINITION: {
-                    this->emplace<ClassDefinition>(document, map_object);
-                    break;
-                }
-                case StatementType::DEFINITION: {
-                    this->emplace<Definition>(document, map_object);
-                    break;
-                }
-                case StatementType::VARIANT_SET: {
-                    this->emplace<VariantSet>(document, map_object);
-                    break;
-                }
-                default:
-                    continue;
+Statement::Statement(AMdoc const* const document,
+                     AMitem const* const map_object,
+                     std::shared_ptr<AMresult> const& type) {
+    // Only construct the alternative named by the map object's type and let it
+    // reuse the type instead of getting it again.
+    auto result = type;
+    auto const tag = detail::extract_map_type(document, map_object, extract_StatementType, result);
+    detail::Arguments args;
+    try {
+        switch (tag.value_or(StatementType::END__)) {
+            case StatementType::CLASS_DEFINITION: {
+                this->emplace<ClassDefinition>(document, map_object, result);
+                break;
+            }
+            case StatementType::DEFINITION: {
+                this->emplace<Definition>(document, map_object, result);
+                break;
             }
-            args.str("");
-            break;
-        } catch (std::invalid_argument const& thrown) {
-            if (!args.str().empty()) {
-                args << " | ";
+            case StatementType::VARIANT_SET: {
+                this->emplace<VariantSet>(document, map_object, result);
+                break;
             }
-            args << thrown.what();
+            default:
+                // E.g. a declaration or a variant definition.
+                detail::describe_map_type(document, map_object, result.get(), args);
         }
+    } catch (std::invalid_argument const& thrown) {
+        args << thrown.what();
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
@@ -29,6 +29,7 @@
 
 #include <iostream>
 #include <map>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -50,6 +51,14 @@ static std::map<std::string_view, StatementType> const TAGS = {
 namespace cavi {
 namespace usdj_am {
 
+std::optional<StatementType> extract_StatementType(std::string_view const& view) {
+    auto const match = TAGS.find(view);
+    if (match != TAGS.end()) {
+        return match->second;
+    }
+    return std::nullopt;
+}
+
 std::istream& operator>>(std::istream& is, StatementType& out) {
     std::string token;
     if (is >> token) {
@@ -40,13 +40,15 @@ extern "C" {
 }
 
 // local
+#include "detail/arguments.hpp"
 #include "string_.hpp"
+#include "utils/result_arena.hpp"
 
 namespace cavi {
 namespace usdj_am {
 
 String::String(AMdoc const* const document, AMitem const* const item) : m_document{document} {
-    std::ostringstream args;
+    detail::Arguments args;
     if (!document) {
         args << "document == nullptr, ...";
     } else if (!item) {
@@ -59,9 +61,9 @@ String::String(AMdoc const* const document, AMitem const* const item) : m_docume
                 AMobjType const obj_type = AMobjObjType(document, obj_id);
                 if (obj_type == AM_OBJ_TYPE_TEXT) {
                     // Preserve the AMitem storing the text object's ID.
-                    m_results[OBJ_ID] = ResultPtr{AMitemResult(item), AMresultFree};
+                    m_results[OBJ_ID] = utils::ResultArena::adopt(AMitemResult(item));
                     // Preserve the AMitem storing the text object's contents.
-                    m_results[ITEM] = ResultPtr{AMtext(m_document, obj_id, nullptr), AMresultFree};
+                    m_results[ITEM] = utils::ResultArena::adopt(AMtext(m_document, obj_id, nullptr));
                 } else {
                     args << "AMobjObjType(document, AMitemObjId(item)) == " << AMobjTypeToString(obj_type);
                 }
@@ -69,7 +71,7 @@ String::String(AMdoc const* const document, AMitem const* const item) : m_docume
             }
             case AM_VAL_TYPE_STR: {
                 // Preserve the AMitem storing the string.
-                m_results[ITEM] = ResultPtr{AMitemResult(item), AMresultFree};
+                m_results[ITEM] = utils::ResultArena::adopt(AMitemResult(item));
                 break;
             }
             default: {
@@ -78,7 +80,7 @@ String::String(AMdoc const* const document, AMitem const* const item) : m_docume
             }
         }
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
@@ -27,11 +27,15 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <filesystem>
 #include <fstream>
 #include <limits>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <system_error>
 #include <typeinfo>
 #include <vector>
 
@@ -102,6 +106,37 @@ Document Document::load(std::filesystem::path const& filename) {
     return Document(std::move(result));
 }
 
+std::size_t Document::get_whole_chunks_size(std::uint8_t const* const src, std::size_t const count) {
+    static std::array<std::uint8_t, 4> const MAGIC_BYTES = {0x85, 0x6f, 0x4a, 0x83};
+    // The magic bytes, the checksum and the chunk type precede the length.
+    static std::size_t const HEADER_SIZE = MAGIC_BYTES.size() + 4 + 1;
+
+    std::size_t size = 0;
+    if (!src) {
+        return size;
+    }
+    while (count - size > HEADER_SIZE) {
+        std::uint8_t const* const chunk = src + size;
+        if (!std::equal(MAGIC_BYTES.begin(), MAGIC_BYTES.end(), chunk)) {
+            break;
+        }
+        // The length of the chunk's contents is an unsigned LEB128 integer.
+        std::size_t offset = HEADER_SIZE;
+        std::uint64_t length = 0;
+        bool terminated = false;
+        for (unsigned shift = 0; !terminated && shift < 64 && size + offset < count; shift += 7) {
+            std::uint8_t const byte = chunk[offset++];
+            length |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            terminated = !(byte & 0x80);
+        }
+        if (!terminated || length > count - size - offset) {
+            break;
+        }
+        size += offset + length;
+    }
+    return size;
+}
+
 Document::Document(ResultPtr&& result) : m_document{nullptr}, m_result{std::move(result)} {
     std::ostringstream args;
     if (!m_result) {
@@ -167,7 +202,59 @@ std::size_t Document::save(std::filesystem::path const& filename) const {
         if (!AMitemToBytes(item, &bytes)) {
             args << "AMitemToBytes(..., ...) == " << std::boolalpha << false << std::noboolalpha;
         } else {
-            std::ofstream ofs{filename, std::ios::binary | std::ios::out};
+            // Write a temporary file and then rename it over the original one.
+            auto temp_filename = filename;
+            temp_filename += ".tmp";
+            std::ofstream ofs{temp_filename, std::ios::binary | std::ios::out};
+            if (!ofs.is_open()) {
+                args << typeid(decltype(ofs)).name() << "{" << temp_filename << ", ...}.is_open() == "
+                     << std::boolalpha << false << std::noboolalpha;
+            } else {
+                ofs.write(reinterpret_cast<decltype(ofs)::char_type const*>(bytes.src), bytes.count);
+                if (!ofs.good()) {
+                    auto const fmtflags = args.flags();
+                    args << typeid(decltype(ofs)).name() << "{" << temp_filename << ", ...}.write(" << std::showbase
+                         << std::hex << bytes.src << ", " << std::dec << bytes.count << ").good() == " << std::boolalpha
+                         << false;
+                    args.setf(fmtflags);
+                }
+                ofs.close();
+                std::error_code error_code;
+                if (args.tellp() == 0) {
+                    std::filesystem::rename(temp_filename, filename, error_code);
+                    if (error_code) {
+                        args << "std::filesystem::rename(" << temp_filename << ", " << filename
+                             << ", ...) == " << error_code.message();
+                    }
+                }
+                if (args.tellp() != 0) {
+                    std::filesystem::remove(temp_filename, error_code);
+                } else {
+                    count = bytes.count;
+                }
+            }
+        }
+    }
+    throw_on_error(__func__, args.str());
+    return count;
+}
+
+std::size_t Document::save_incremental(std::filesystem::path const& filename) const {
+    std::ostringstream args;
+    std::size_t count = 0;
+    ResultPtr const result{AMsaveIncremental(m_document), AMresultFree};
+    if (AMresultStatus(result.get()) != AM_STATUS_OK) {
+        args << "AMresultError(AMsaveIncremental(...)) == \"" << from_bytes(AMresultError(result.get())) << "\"";
+    } else {
+        AMitem const* const item = AMresultItem(result.get());
+        AMbyteSpan bytes;
+        if (!AMitemToBytes(item, &bytes)) {
+            args << "AMitemToBytes(..., ...) == " << std::boolalpha << false << std::noboolalpha;
+        } else if (bytes.count) {
+            std::error_code error_code;
+            auto const file_size = std::filesystem::file_size(filename, error_code);
+            // A change chunk can follow a document chunk or another change chunk.
+            std::ofstream ofs{filename, std::ios::binary | std::ios::out | std::ios::app};
             if (!ofs.is_open()) {
                 args << typeid(decltype(ofs)).name() << "{" << filename << ", ...}.is_open() == " << std::boolalpha
                      << false << std::noboolalpha;
@@ -181,7 +268,14 @@ std::size_t Document::save(std::filesystem::path const& filename) const {
                     args.setf(fmtflags);
                 }
                 ofs.close();
-                count = bytes.count;
+                if (args.tellp() != 0) {
+                    // Don't leave part of a chunk behind for `load()` to reject.
+                    if (!error_code) {
+                        std::filesystem::resize_file(filename, file_size, error_code);
+                    }
+                } else {
+                    count = bytes.count;
+                }
             }
         }
     }
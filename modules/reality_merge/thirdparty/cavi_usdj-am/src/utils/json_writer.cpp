@@ -43,6 +43,7 @@
 #include "external_reference.hpp"
 #include "external_reference_import.hpp"
 #include "file.hpp"
+#include "node.hpp"
 #include "object_declaration.hpp"
 #include "object_declaration_entries.hpp"
 #include "object_declaration_list.hpp"
@@ -58,14 +59,15 @@ namespace cavi {
 namespace usdj_am {
 namespace utils {
 
-JsonWriter::JsonWriter(JsonWriter::Indenter&& indenter, std::size_t const precision)
-    : m_indenter{std::move(indenter)}, m_precision{precision} {}
+JsonWriter::JsonWriter(JsonWriter::Indenter&& indenter, std::size_t const precision, bool const materialize)
+    : m_indenter{std::move(indenter)}, m_materialize{materialize}, m_precision{precision} {}
 
 JsonWriter::operator std::string() const {
     return m_os.str();
 }
 
 void JsonWriter::visit(Assignment const& assignment) {
+    prepare(assignment);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << assignment.get_type() << "\",\n";
@@ -97,6 +99,7 @@ void JsonWriter::visit(ClassDeclaration const& class_declaration) {
 }
 
 void JsonWriter::visit(Declaration const& declaration) {
+    prepare(declaration);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << declaration.get_type() << "\",\n";
@@ -127,6 +130,7 @@ void JsonWriter::visit(Declaration const& declaration) {
 }
 
 void JsonWriter::visit(Definition const& definition) {
+    prepare(definition);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << definition.get_type() << "\",\n";
@@ -166,6 +170,7 @@ void JsonWriter::visit(DefinitionStatement const& definition_statement) {
 }
 
 void JsonWriter::visit(Descriptor const& descriptor) {
+    prepare(descriptor);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"description\": ";
@@ -184,6 +189,7 @@ void JsonWriter::visit(Descriptor const& descriptor) {
 }
 
 void JsonWriter::visit(ExternalReference const& external_reference) {
+    prepare(external_reference);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << external_reference.get_type() << "\",\n";
@@ -204,6 +210,7 @@ void JsonWriter::visit(ExternalReference const& external_reference) {
 }
 
 void JsonWriter::visit(ExternalReferenceImport const& external_reference_import) {
+    prepare(external_reference_import);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << external_reference_import.get_type() << "\",\n";
@@ -222,6 +229,7 @@ void JsonWriter::visit(ExternalReferenceImport const& external_reference_import)
 
 void JsonWriter::visit(File const& file) {
     try {
+        prepare(file);
         m_os << "{\n";
         m_os << m_indenter << "\"version\": " << file.get_version() << ",\n";
         m_os << m_indenter << "\"descriptor\": ";
@@ -243,6 +251,7 @@ void JsonWriter::visit(File const& file) {
 }
 
 void JsonWriter::visit(ObjectDeclaration const& object_declaration) {
+    prepare(object_declaration);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"keyword\": ";
@@ -264,6 +273,7 @@ void JsonWriter::visit(ObjectDeclaration const& object_declaration) {
 }
 
 void JsonWriter::visit(ObjectDeclarationEntries const& object_declaration_entries) {
+    prepare(object_declaration_entries);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << object_declaration_entries.get_type() << "\",\n";
@@ -285,6 +295,7 @@ void JsonWriter::visit(ObjectDeclarations const& object_declarations) {
 }
 
 void JsonWriter::visit(ObjectValue const& object_value) {
+    prepare(object_value);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << object_value.get_type() << "\",\n";
@@ -297,6 +308,7 @@ void JsonWriter::visit(ObjectValue const& object_value) {
 }
 
 void JsonWriter::visit(ReferenceFile const& reference_file) {
+    prepare(reference_file);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << reference_file.get_type() << "\",\n";
@@ -350,6 +362,7 @@ void JsonWriter::visit(Value const& value) {
 }
 
 void JsonWriter::visit(VariantDefinition const& variant_definition) {
+    prepare(variant_definition);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << variant_definition.get_type() << "\",\n";
@@ -370,6 +383,7 @@ void JsonWriter::visit(VariantDefinition const& variant_definition) {
 }
 
 void JsonWriter::visit(VariantSet const& variant_set) {
+    prepare(variant_set);
     m_os << "{\n";
     ++m_indenter;
     m_os << m_indenter << "\"type\": \"" << variant_set.get_type() << "\",\n";
@@ -381,6 +395,12 @@ void JsonWriter::visit(VariantSet const& variant_set) {
     m_os << m_indenter << "}";
 }
 
+void JsonWriter::prepare(Node const& node) const {
+    if (m_materialize) {
+        node.materialize();
+    }
+}
+
 template <typename InputRangeT>
 void JsonWriter::write_array(InputRangeT const& array_range) {
     m_os << "[";
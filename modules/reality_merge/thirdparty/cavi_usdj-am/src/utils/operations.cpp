@@ -0,0 +1,429 @@
+/**************************************************************************/
+/* operations.cpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_set>
+#include <utility>
+
+// third-party
+extern "C" {
+
+#include <automerge-c/automerge.h>
+}
+
+// local
+#include "utils/bytes.hpp"
+#include "utils/document.hpp"
+#include "utils/operations.hpp"
+
+namespace {
+
+using Action = cavi::usdj_am::utils::Operations::Action;
+
+/// \brief The IDs of the columns of a change chunk's operations, each shifted
+///        above the 4 bits of its type.
+enum ColumnSpec : std::uint64_t {
+    OBJ_ACTOR = (0 << 4) | 1,
+    OBJ_CTR = (0 << 4) | 2,
+    KEY_STR = (1 << 4) | 5,
+    INSERT = (3 << 4) | 4,
+    ACTION = (4 << 4) | 2,
+    PRED_NUM = (7 << 4) | 0,
+    PRED_ACTOR = (7 << 4) | 1,
+    PRED_CTR = (7 << 4) | 3,
+};
+
+/// \brief The bit of a column's specification that marks it as compressed.
+std::uint64_t const DEFLATE = 1 << 3;
+
+/// \brief Reads the primitive values of Automerge's binary format.
+class Reader {
+public:
+    Reader(std::uint8_t const* const src, std::size_t const count) : m_src{src}, m_count{count}, m_offset{0} {}
+
+    bool done() const {
+        return m_offset == m_count;
+    }
+
+    std::size_t get_offset() const {
+        return m_offset;
+    }
+
+    /// \throws std::invalid_argument
+    std::string_view read_bytes(std::size_t const count) {
+        if (count > m_count - m_offset)
+            throw std::invalid_argument("truncated chunk");
+        std::string_view const bytes{reinterpret_cast<char const*>(m_src + m_offset), count};
+        m_offset += count;
+        return bytes;
+    }
+
+    /// \brief Reads a byte array that's prefixed by its length.
+    ///
+    /// \throws std::invalid_argument
+    std::string_view read_prefixed() {
+        return read_bytes(read_uleb());
+    }
+
+    /// \brief Reads a signed LEB128 integer.
+    ///
+    /// \throws std::invalid_argument
+    std::int64_t read_sleb() {
+        std::uint64_t value = 0;
+        unsigned shift = 0;
+        std::uint8_t byte = read_byte(shift);
+        for (value |= byte & 0x7f, shift += 7; byte & 0x80; shift += 7) {
+            byte = read_byte(shift);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        }
+        if (shift < 64 && (byte & 0x40))
+            value |= ~std::uint64_t{0} << shift;
+        return static_cast<std::int64_t>(value);
+    }
+
+    /// \brief Reads an unsigned LEB128 integer.
+    ///
+    /// \throws std::invalid_argument
+    std::uint64_t read_uleb() {
+        std::uint64_t value = 0;
+        unsigned shift = 0;
+        std::uint8_t byte = 0;
+        do {
+            byte = read_byte(shift);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return value;
+    }
+
+private:
+    /// \throws std::invalid_argument
+    std::uint8_t read_byte(unsigned const shift) {
+        if (shift >= 64)
+            throw std::invalid_argument("overlong LEB128 integer");
+        if (m_offset == m_count)
+            throw std::invalid_argument("truncated chunk");
+        return m_src[m_offset++];
+    }
+
+    std::uint8_t const* const m_src;
+    std::size_t const m_count;
+    std::size_t m_offset;
+};
+
+/// \brief Decodes a run-length encoded column.
+///
+/// \param[in] column The bytes of the column.
+/// \param[in] read_value A function that reads one value of the column.
+/// \throws std::invalid_argument
+template <typename T>
+std::vector<std::optional<T>> decode_rle(std::string_view const& column, std::function<T(Reader&)> const& read_value) {
+    std::vector<std::optional<T>> values;
+    Reader reader{reinterpret_cast<std::uint8_t const*>(column.data()), column.size()};
+    while (!reader.done()) {
+        auto const count = reader.read_sleb();
+        if (count > 0) {
+            // A run of a repeated value.
+            values.insert(values.end(), static_cast<std::size_t>(count), read_value(reader));
+        } else if (count < 0) {
+            // A run of literal values.
+            for (auto remaining = count; remaining != 0; ++remaining) {
+                values.emplace_back(read_value(reader));
+            }
+        } else {
+            // A run of nulls.
+            values.insert(values.end(), static_cast<std::size_t>(reader.read_uleb()), std::nullopt);
+        }
+    }
+    return values;
+}
+
+/// \throws std::invalid_argument
+std::vector<std::optional<std::uint64_t>> decode_uint_rle(std::string_view const& column) {
+    return decode_rle<std::uint64_t>(column, [](Reader& reader) { return reader.read_uleb(); });
+}
+
+/// \brief Decodes a column of differences between consecutive values.
+///
+/// \throws std::invalid_argument
+std::vector<std::optional<std::uint64_t>> decode_delta(std::string_view const& column) {
+    std::vector<std::optional<std::uint64_t>> values;
+    std::int64_t value = 0;
+    for (auto const& delta : decode_rle<std::int64_t>(column, [](Reader& reader) { return reader.read_sleb(); })) {
+        if (delta) {
+            value += *delta;
+            values.emplace_back(static_cast<std::uint64_t>(value));
+        } else {
+            values.emplace_back(std::nullopt);
+        }
+    }
+    return values;
+}
+
+/// \brief Decodes a column of alternating runs of `false` and `true`.
+///
+/// \throws std::invalid_argument
+std::vector<bool> decode_boolean(std::string_view const& column) {
+    std::vector<bool> values;
+    Reader reader{reinterpret_cast<std::uint8_t const*>(column.data()), column.size()};
+    for (bool value = false; !reader.done(); value = !value) {
+        values.insert(values.end(), static_cast<std::size_t>(reader.read_uleb()), value);
+    }
+    return values;
+}
+
+/// \throws std::invalid_argument
+std::vector<std::optional<std::string_view>> decode_string_rle(std::string_view const& column) {
+    return decode_rle<std::string_view>(column, [](Reader& reader) { return reader.read_prefixed(); });
+}
+
+/// \returns The value at a position within a column or `std::nullopt` if the
+///          column is too short to have one there.
+template <typename T>
+std::optional<T> get(std::vector<std::optional<T>> const& values, std::size_t const pos) {
+    return (pos < values.size()) ? values[pos] : std::nullopt;
+}
+
+/// \brief Encodes an object or operation ID like `Operations::make_key()`.
+std::string make_key(std::uint64_t const counter, std::string_view const& actor_id) {
+    std::string key;
+    key.reserve(sizeof(counter) + actor_id.size());
+    key.append(reinterpret_cast<char const*>(&counter), sizeof(counter));
+    key.append(actor_id);
+    return key;
+}
+
+}  // namespace
+
+namespace cavi {
+namespace usdj_am {
+namespace utils {
+
+std::string Operations::make_key(AMobjId const* const object_id) {
+    if (!object_id || !AMobjIdCounter(object_id)) {
+        // It's the root object.
+        return {};
+    }
+    auto const actor_id = AMactorIdBytes(AMobjIdActorId(object_id));
+    return ::make_key(AMobjIdCounter(object_id), from_bytes(actor_id));
+}
+
+Operations::Operations(AMdoc* const document, AMitems const* const before_heads, AMitems const* const after_heads) {
+    std::ostringstream args;
+    if (!document) {
+        args << "document == nullptr, ...";
+    } else {
+        Document::ResultPtr const result{AMgetChanges(document, before_heads), AMresultFree};
+        Document::ResultPtr later_result{nullptr, AMresultFree};
+        if (AMresultStatus(result.get()) != AM_STATUS_OK) {
+            args << "..., AMresultError(AMgetChanges(..., before_heads)) == \""
+                 << from_bytes(AMresultError(result.get())) << "\", ...";
+        } else if (after_heads) {
+            later_result.reset(AMgetChanges(document, after_heads));
+            if (AMresultStatus(later_result.get()) != AM_STATUS_OK) {
+                args << "..., AMresultError(AMgetChanges(..., after_heads)) == \""
+                     << from_bytes(AMresultError(later_result.get())) << "\"";
+            }
+        }
+        if (args.str().empty()) {
+            // Exclude the changes that were made after the later version.
+            std::unordered_set<std::string_view> later_hashes;
+            if (later_result) {
+                AMitems items = AMresultItems(later_result.get());
+                AMitem* item = nullptr;
+                while ((item = AMitemsNext(&items, 1)) != nullptr) {
+                    AMchange* change = nullptr;
+                    if (AMitemToChange(item, &change))
+                        later_hashes.insert(from_bytes(AMchangeHash(change)));
+                }
+            }
+            AMitems items = AMresultItems(result.get());
+            AMitem* item = nullptr;
+            while ((item = AMitemsNext(&items, 1)) != nullptr) {
+                AMchange* change = nullptr;
+                if (!AMitemToChange(item, &change) || later_hashes.count(from_bytes(AMchangeHash(change))))
+                    continue;
+                auto const raw_bytes = AMchangeRawBytes(change);
+                try {
+                    decode(raw_bytes.src, raw_bytes.count);
+                } catch (std::invalid_argument const& thrown) {
+                    args << "..., " << thrown.what();
+                    break;
+                }
+            }
+        }
+    }
+    if (!args.str().empty()) {
+        std::ostringstream what;
+        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
+        throw std::invalid_argument(what.str());
+    }
+}
+
+Operations::Operations(std::uint8_t const* const src, std::size_t const count) {
+    std::ostringstream args;
+    if (!src && count) {
+        args << "src == nullptr, count == " << count;
+    } else {
+        try {
+            for (std::size_t offset = 0; offset != count;) {
+                offset += decode(src + offset, count - offset);
+            }
+        } catch (std::invalid_argument const& thrown) {
+            args << thrown.what();
+        }
+    }
+    if (!args.str().empty()) {
+        std::ostringstream what;
+        what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
+        throw std::invalid_argument(what.str());
+    }
+}
+
+std::size_t Operations::decode(std::uint8_t const* const src, std::size_t const count) {
+    static std::string_view const MAGIC_BYTES{"\x85\x6f\x4a\x83", 4};
+    static std::uint8_t const CHANGE_CHUNK_TYPE = 1;
+
+    Reader header{src, count};
+    if (header.read_bytes(MAGIC_BYTES.size()) != MAGIC_BYTES)
+        throw std::invalid_argument("not a chunk");
+    // Skip the checksum.
+    header.read_bytes(4);
+    auto const chunk_type = static_cast<std::uint8_t>(header.read_bytes(1).front());
+    if (chunk_type != CHANGE_CHUNK_TYPE) {
+        std::ostringstream what;
+        what << "chunk type " << static_cast<unsigned>(chunk_type) << " isn't an uncompressed change";
+        throw std::invalid_argument(what.str());
+    }
+    auto const length = header.read_uleb();
+    auto const contents = header.read_bytes(length);
+    Reader reader{reinterpret_cast<std::uint8_t const*>(contents.data()), contents.size()};
+    // Skip the dependencies' hashes.
+    reader.read_bytes(reader.read_uleb() * 32);
+    std::vector<std::string_view> actor_ids;
+    actor_ids.push_back(reader.read_prefixed());
+    // Skip the sequence number.
+    reader.read_uleb();
+    auto const start_op = reader.read_uleb();
+    // Skip the timestamp and the message.
+    reader.read_sleb();
+    reader.read_prefixed();
+    for (auto other_actors = reader.read_uleb(); other_actors != 0; --other_actors) {
+        actor_ids.push_back(reader.read_prefixed());
+    }
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> specs;
+    for (auto columns = reader.read_uleb(); columns != 0; --columns) {
+        auto const spec = reader.read_uleb();
+        specs.emplace_back(spec, reader.read_uleb());
+    }
+    std::string_view obj_actor, obj_ctr, key_str, insert, action, pred_num, pred_actor, pred_ctr;
+    for (auto const& spec : specs) {
+        auto const column = reader.read_bytes(spec.second);
+        if (spec.first & DEFLATE) {
+            if (column.empty())
+                continue;
+            throw std::invalid_argument("compressed column");
+        }
+        switch (spec.first) {
+            case OBJ_ACTOR:
+                obj_actor = column;
+                break;
+            case OBJ_CTR:
+                obj_ctr = column;
+                break;
+            case KEY_STR:
+                key_str = column;
+                break;
+            case INSERT:
+                insert = column;
+                break;
+            case ACTION:
+                action = column;
+                break;
+            case PRED_NUM:
+                pred_num = column;
+                break;
+            case PRED_ACTOR:
+                pred_actor = column;
+                break;
+            case PRED_CTR:
+                pred_ctr = column;
+                break;
+            default:
+                // The keys of list elements and the values aren't needed.
+                break;
+        }
+    }
+    auto const actions = decode_uint_rle(action);
+    auto const obj_actors = decode_uint_rle(obj_actor);
+    auto const obj_ctrs = decode_uint_rle(obj_ctr);
+    auto const key_strs = decode_string_rle(key_str);
+    auto const inserts = decode_boolean(insert);
+    auto const pred_nums = decode_uint_rle(pred_num);
+    auto const pred_actors = decode_uint_rle(pred_actor);
+    auto const pred_ctrs = decode_delta(pred_ctr);
+    // An actor is referenced by its position within the change's list.
+    auto const get_actor_id = [&](std::optional<std::uint64_t> const& actor) {
+        if (!actor || *actor >= actor_ids.size())
+            throw std::invalid_argument("unknown actor");
+        return actor_ids[*actor];
+    };
+    m_operations.reserve(m_operations.size() + actions.size());
+    std::size_t pred_pos = 0;
+    for (std::size_t pos = 0; pos != actions.size(); ++pos) {
+        Operation operation{};
+        operation.action = static_cast<Action>(actions[pos].value_or(0));
+        operation.insert = (pos < inserts.size()) && inserts[pos];
+        operation.id = ::make_key(start_op + pos, actor_ids.front());
+        auto const obj_ctr_value = get(obj_ctrs, pos);
+        if (obj_ctr_value) {
+            operation.object = ::make_key(*obj_ctr_value, get_actor_id(get(obj_actors, pos)));
+        }
+        if (auto const key = get(key_strs, pos)) {
+            operation.key.emplace(*key);
+        }
+        for (auto preds = get(pred_nums, pos).value_or(0); preds != 0; --preds, ++pred_pos) {
+            auto const pred_ctr_value = get(pred_ctrs, pred_pos);
+            if (!pred_ctr_value)
+                throw std::invalid_argument("missing predecessor");
+            operation.predecessors.push_back(::make_key(*pred_ctr_value, get_actor_id(get(pred_actors, pred_pos))));
+        }
+        m_operations.push_back(std::move(operation));
+    }
+    return header.get_offset();
+}
+
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
@@ -1,5 +1,5 @@
 /**************************************************************************/
-/* usdj_velocity_extractor.h                                              */
+/* result_arena.cpp                                                       */
 /**************************************************************************/
 /*                         This file is part of:                          */
 /*                             RealityMerge                               */
@@ -27,48 +27,65 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#ifndef REALITY_MERGE_USDJ_VELOCITY_EXTRACTOR_H
-#define REALITY_MERGE_USDJ_VELOCITY_EXTRACTOR_H
-
-#include <optional>
+#include <cassert>
 
 // third-party
-#include <cavi/usdj_am/usd/physics/token_type.hpp>
-#include <cavi/usdj_am/visitor.hpp>
+extern "C" {
 
-struct Vector3;
+#include <automerge-c/automerge.h>
+}
 
-/// \brief An extractor of a velocity value embedded within a "USDA_Definition"
-///        node.
-class UsdjVelocityExtractor : public cavi::usdj_am::Visitor {
-public:
-    UsdjVelocityExtractor() = delete;
+// local
+#include "utils/result_arena.hpp"
 
-    UsdjVelocityExtractor(cavi::usdj_am::Definition const& p_definition);
+namespace {
 
-    UsdjVelocityExtractor(UsdjVelocityExtractor const&) = delete;
+using cavi::usdj_am::utils::ResultArena;
 
-    UsdjVelocityExtractor(UsdjVelocityExtractor&&) = default;
+thread_local ResultArena* current = nullptr;
 
-    ~UsdjVelocityExtractor();
+}  // namespace
 
-    UsdjVelocityExtractor& operator=(UsdjVelocityExtractor const&) = delete;
+namespace cavi {
+namespace usdj_am {
+namespace utils {
 
-    UsdjVelocityExtractor& operator=(UsdjVelocityExtractor&&) = default;
+ResultArena::ResultArena() : m_enclosing{current} {
+    current = this;
+}
 
-    /// \throws std::invalid_argument
-    std::optional<Vector3> operator()(cavi::usdj_am::usd::physics::TokenType const reference);
+ResultArena::~ResultArena() {
+    // Arenas must end in the reverse of the order in which they began.
+    assert(current == this);
+    current = m_enclosing;
+    for (auto result = m_results.rbegin(); result != m_results.rend(); ++result) {
+        AMresultFree(*result);
+    }
+}
 
-    void visit(cavi::usdj_am::Declaration const& declaration) override;
+std::shared_ptr<AMresult> ResultArena::adopt(AMresult* const result) {
+    return adopt(result, current);
+}
 
-    void visit(cavi::usdj_am::Definition const& definition) override;
+std::shared_ptr<AMresult> ResultArena::adopt(AMresult* const result, ResultArena* const arena) {
+    if (!arena || arena != current) {
+        return std::shared_ptr<AMresult>{result, AMresultFree};
+    }
+    if (result) {
+        arena->m_results.push_back(result);
+    }
+    // Alias an empty owner so that the pointer has no control block.
+    return std::shared_ptr<AMresult>{std::shared_ptr<AMresult>{}, result};
+}
 
-    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
+ResultArena* ResultArena::get_current() {
+    return current;
+}
 
-private:
-    cavi::usdj_am::Definition const& m_definition;
-    std::optional<cavi::usdj_am::usd::physics::TokenType> m_reference;
-    std::optional<Vector3> m_velocity;
-};
+std::size_t ResultArena::size() const {
+    return m_results.size();
+}
 
-#endif  // REALITY_MERGE_USDJ_VELOCITY_EXTRACTOR_H
+}  // namespace utils
+}  // namespace usdj_am
+}  // namespace cavi
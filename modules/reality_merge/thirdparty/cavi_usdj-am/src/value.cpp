@@ -27,8 +27,10 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
 #include <type_traits>
 #include <typeinfo>
 
@@ -40,6 +42,8 @@ extern "C" {
 }
 
 // local
+#include "detail/arguments.hpp"
+#include "detail/map_type.hpp"
 #include "external_reference.hpp"
 #include "external_reference_import.hpp"
 #include "object_value.hpp"
@@ -51,7 +55,7 @@ namespace cavi {
 namespace usdj_am {
 
 Value::Value(AMdoc const* const document, AMitem const* const item) {
-    std::ostringstream args;
+    detail::Arguments args;
     try {
         AMvalType const val_type = AMitemValType(item);
         switch (val_type) {
@@ -84,8 +88,21 @@ Value::Value(AMdoc const* const document, AMitem const* const item) {
                     case AM_OBJ_TYPE_MAP: {
                         using Index = typename std::underlying_type<ValueType>::type;
 
+                        // Only try the alternative named by the map object's
+                        // type, if any.
+                        auto const type =
+                            detail::extract_map_type(document, item, [](std::string_view const& view) {
+                                auto tag = extract_ValueType(view);
+                                // This type doesn't name an alternative.
+                                if (tag == ValueType::EXTERNAL_REFERENCE_SRC) {
+                                    tag.reset();
+                                }
+                                return tag;
+                            });
                         for (Index index = static_cast<Index>(ValueType::BEGIN__);
                              index != static_cast<Index>(ValueType::END__); ++index) {
+                            if (type && static_cast<ValueType>(index) != *type)
+                                continue;
                             try {
                                 switch (static_cast<ValueType>(index)) {
                                     case ValueType::EXTERNAL_REFERENCE: {
@@ -103,10 +120,10 @@ Value::Value(AMdoc const* const document, AMitem const* const item) {
                                     default:
                                         continue;
                                 }
-                                args.str("");
+                                args.clear();
                                 break;
                             } catch (std::invalid_argument const& thrown) {
-                                if (!args.str().empty()) {
+                                if (args) {
                                     args << " | ";
                                 }
                                 args << thrown.what();
@@ -137,7 +154,7 @@ Value::Value(AMdoc const* const document, AMitem const* const item) {
     } catch (std::invalid_argument const& thrown) {
         args << thrown.what();
     }
-    if (!args.str().empty()) {
+    if (args) {
         std::ostringstream what;
         what << typeid(*this).name() << "::" << __func__ << "(" << args.str() << ")";
         throw std::invalid_argument(what.str());
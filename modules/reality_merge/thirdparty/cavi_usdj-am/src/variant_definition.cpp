@@ -27,17 +27,37 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "variant_definition.hpp"
 #include "descriptor.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property DEFINITIONS{0, "definitions"};
+constexpr Node::Property DESCRIPTOR{1, "descriptor"};
+constexpr Node::Property NAME{2, "name"};
+constexpr Node::Property TYPE{3, "type"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 4> ALL = {DEFINITIONS, DESCRIPTOR, NAME, TYPE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
 VariantDefinition::VariantDefinition(AMdoc const* const document, AMitem const* const map_object)
-    : Node(document, map_object, 4) {
-    check_enum_property("type", StatementType::VARIANT_DEF);
+    : Node(document, map_object, property::ALL) {
+    check_enum_property(property::TYPE, StatementType::VARIANT_DEF);
 }
 
 void VariantDefinition::accept(Visitor& visitor) const& {
@@ -49,15 +69,15 @@ void VariantDefinition::accept(Visitor& visitor) && {
 }
 
 VariantDefinition::Definitions VariantDefinition::get_definitions() const {
-    return get_array_property<Definitions>("definitions");
+    return get_array_property<Definitions>(property::DEFINITIONS);
 }
 
 std::optional<Descriptor> VariantDefinition::get_descriptor() const {
-    return get_nullable_object_property<Descriptor>("descriptor");
+    return get_nullable_object_property<Descriptor>(property::DESCRIPTOR);
 }
 
 String VariantDefinition::get_name() const {
-    return get_object_property<String>("name");
+    return get_object_property<String>(property::NAME);
 }
 
 }  // namespace usdj_am
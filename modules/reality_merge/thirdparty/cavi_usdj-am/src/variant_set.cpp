@@ -27,15 +27,38 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <array>
+
 // local
 #include "variant_set.hpp"
 #include "visitor.hpp"
 
+namespace {
+
+using cavi::usdj_am::Node;
+
+namespace property {
+
+constexpr Node::Property DEFINITIONS{0, "definitions"};
+constexpr Node::Property NAME{1, "name"};
+constexpr Node::Property TYPE{2, "type"};
+
+/// \brief All of the properties by slot.
+constexpr std::array<Node::Property, 3> ALL = {DEFINITIONS, NAME, TYPE};
+
+}  // namespace property
+
+}  // namespace
+
 namespace cavi {
 namespace usdj_am {
 
-VariantSet::VariantSet(AMdoc const* const document, AMitem const* const map_object) : Node(document, map_object, 3) {
-    check_enum_property("type", StatementType::VARIANT_SET);
+VariantSet::VariantSet(AMdoc const* const document,
+                       AMitem const* const map_object,
+                       std::shared_ptr<AMresult> const& type)
+    : Node(document, map_object, property::ALL) {
+    reuse_property(property::TYPE, type);
+    check_enum_property(property::TYPE, StatementType::VARIANT_SET);
 }
 
 void VariantSet::accept(Visitor& visitor) const& {
@@ -47,11 +70,11 @@ void VariantSet::accept(Visitor& visitor) && {
 }
 
 String VariantSet::get_name() const {
-    return get_object_property<String>("name");
+    return get_object_property<String>(property::NAME);
 }
 
 VariantSet::VariantDefinitions VariantSet::get_definitions() const {
-    return get_array_property<VariantDefinitions>("definitions");
+    return get_array_property<VariantDefinitions>(property::DEFINITIONS);
 }
 
 }  // namespace usdj_am
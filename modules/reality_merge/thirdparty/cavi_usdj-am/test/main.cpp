@@ -1,17 +1,26 @@
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 // third-party
 #if defined(_MSC_VER)
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #else
 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include <catch2/catch.hpp>
 #endif
 
@@ -19,9 +28,15 @@
 #include <cavi/usdj_am/assignment.hpp>
 #include <cavi/usdj_am/descriptor.hpp>
 #include <cavi/usdj_am/file.hpp>
+#include <cavi/usdj_am/object_declaration_list.hpp>
+#include <cavi/usdj_am/scene_changes.hpp>
+#include <cavi/usdj_am/scene_index.hpp>
+#include <cavi/usdj_am/statement.hpp>
 #include <cavi/usdj_am/utils/document.hpp>
 #include <cavi/usdj_am/utils/item.hpp>
 #include <cavi/usdj_am/utils/json_writer.hpp>
+#include <cavi/usdj_am/utils/operations.hpp>
+#include <cavi/usdj_am/utils/result_arena.hpp>
 
 using std::filesystem::exists;
 using std::filesystem::file_size;
@@ -54,6 +69,112 @@ TEST_CASE("Validate `Document` loading and saving", "[Document]") {
     CHECK(file_mismatch.first == std::istreambuf_iterator<std::ifstream::char_type>());
 }
 
+TEST_CASE("Validate `Document` incremental saving", "[Document]") {
+    using namespace cavi::usdj_am;
+
+    path const TEMP = temp_directory_path();
+    auto document = utils::Document::load(ROOT / ASSETS / "helloWorld.usdj-am");
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    auto save_path = TEMP / "helloWorld.incremental.usdj-am";
+    auto const snapshot_size = document.save(save_path);
+    CHECK(file_size(save_path) == snapshot_size);
+    // Nothing has changed since the snapshot.
+    CHECK(document.save_incremental(save_path) == 0);
+    utils::Document::ResultPtr const put_result{
+        AMmapPutStr(document, AM_ROOT, AMstr("comment"), AMstr("appended")), AMresultFree};
+    CHECK(AMresultStatus(put_result.get()) == AM_STATUS_OK);
+    auto const increment_size = document.save_incremental(save_path);
+    CHECK(increment_size > 0);
+    CHECK(file_size(save_path) == snapshot_size + increment_size);
+    // The snapshot followed by the change chunk is still loadable.
+    auto loaded = utils::Document::load(save_path);
+    utils::Document::ResultPtr const get_result{AMmapGet(loaded, AM_ROOT, AMstr("comment"), nullptr), AMresultFree};
+    AMbyteSpan value;
+    CHECK(AMitemToStr(AMresultItem(get_result.get()), &value));
+    CHECK(std::string(reinterpret_cast<char const*>(value.src), value.count) == "appended");
+    // A crash while appending can truncate the change chunk.
+    std::ifstream ifs{save_path, std::ios::binary};
+    std::vector<std::uint8_t> const bytes{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    CHECK(utils::Document::get_whole_chunks_size(bytes.data(), bytes.size()) == bytes.size());
+    CHECK(utils::Document::get_whole_chunks_size(bytes.data(), bytes.size() - 1) == snapshot_size);
+    CHECK(utils::Document::get_whole_chunks_size(bytes.data(), snapshot_size - 1) == 0);
+}
+
+TEST_CASE("Validate `utils::Operations` decoding", "[utils::Operations]") {
+    using namespace cavi::usdj_am;
+    using Action = utils::Operations::Action;
+
+    path const TEMP = temp_directory_path();
+    auto document = utils::Document::load(ROOT / "brave-ape-49.automerge");
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    auto save_path = TEMP / "brave-ape-49.operations.automerge";
+    auto const snapshot_size = document.save(save_path);
+    utils::Document::ResultPtr const heads0{AMgetHeads(document), AMresultFree};
+    AMitems const items0 = AMresultItems(heads0.get());
+    utils::Document::ResultPtr const put_result{AMmapPutInt(document, AM_ROOT, AMstr("presence"), 1), AMresultFree};
+    CHECK(AMresultStatus(put_result.get()) == AM_STATUS_OK);
+    utils::Document::ResultPtr const heads1{AMgetHeads(document), AMresultFree};
+    AMitems const items1 = AMresultItems(heads1.get());
+    CHECK_THROWS_AS(utils::Operations(nullptr, &items0, &items1), std::invalid_argument);
+    CHECK(utils::Operations{document, &items1, nullptr}.empty());
+    auto const operations = utils::Operations{document, &items0, &items1};
+    REQUIRE(operations.size() == 1);
+    auto const& operation = *operations.begin();
+    CHECK(operation.action == Action::SET);
+    CHECK_FALSE(operation.insert);
+    CHECK(operation.object == utils::Operations::make_key(AM_ROOT));
+    CHECK(operation.key == "presence");
+    CHECK(operation.predecessors.empty());
+    // An incremental save appends the same change chunk.
+    auto const increment_size = document.save_incremental(save_path);
+    std::ifstream ifs{save_path, std::ios::binary};
+    std::vector<std::uint8_t> const bytes{std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    REQUIRE(bytes.size() == snapshot_size + increment_size);
+    auto const appended = utils::Operations{bytes.data() + snapshot_size, increment_size};
+    REQUIRE(appended.size() == 1);
+    CHECK(appended.begin()->id == operation.id);
+    CHECK_THROWS_AS(utils::Operations(bytes.data() + snapshot_size, increment_size - 1), std::invalid_argument);
+    // A document chunk isn't a change chunk.
+    CHECK_THROWS_AS(utils::Operations(bytes.data(), snapshot_size), std::invalid_argument);
+    // Overwriting a property deletes its previous value.
+    utils::Document::ResultPtr const overwrite_result{AMmapPutInt(document, AM_ROOT, AMstr("presence"), 2),
+                                                      AMresultFree};
+    CHECK(AMresultStatus(overwrite_result.get()) == AM_STATUS_OK);
+    auto const overwrites = utils::Operations{document, &items1, nullptr};
+    REQUIRE(overwrites.size() == 1);
+    CHECK(overwrites.begin()->predecessors == std::vector<std::string>{operation.id});
+}
+
+TEST_CASE("Validate `SceneIndex` change detection", "[SceneIndex]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "brave-ape-49.automerge");
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    auto const scene_item = document.get_item("/data/scene");
+    CHECK_THROWS_AS(SceneIndex(nullptr, scene_item), std::invalid_argument);
+    auto const index = SceneIndex{document, scene_item};
+    CHECK(index.size() > 1);
+    CHECK(AMobjIdEqual(index.get_file_object_id(), AMitemObjId(scene_item)));
+    utils::Document::ResultPtr const heads0{AMgetHeads(document), AMresultFree};
+    AMitems const items0 = AMresultItems(heads0.get());
+    // A change outside of the scene.
+    utils::Document::ResultPtr const root_put{AMmapPutInt(document, AM_ROOT, AMstr("presence"), 1), AMresultFree};
+    CHECK(AMresultStatus(root_put.get()) == AM_STATUS_OK);
+    utils::Document::ResultPtr const heads1{AMgetHeads(document), AMresultFree};
+    AMitems const items1 = AMresultItems(heads1.get());
+    CHECK_FALSE(index.is_changed(utils::Operations{document, &items0, &items1}));
+    CHECK_FALSE(index.is_changed(utils::Operations{document, &items1, &items1}));
+    // A change within the scene.
+    auto const descriptor_item = document.get_item("/data/scene/descriptor");
+    utils::Document::ResultPtr const scene_put{
+        AMmapPutInt(document, AMitemObjId(descriptor_item), AMstr("presence"), 1), AMresultFree};
+    CHECK(AMresultStatus(scene_put.get()) == AM_STATUS_OK);
+    utils::Document::ResultPtr const heads2{AMgetHeads(document), AMresultFree};
+    AMitems const items2 = AMresultItems(heads2.get());
+    CHECK(index.is_changed(utils::Operations{document, &items1, &items2}));
+    CHECK(index.is_changed(utils::Operations{document, &items0, &items2}));
+}
+
 TEST_CASE("Load a USDJ-AM file", "[File]") {
     using namespace cavi::usdj_am;
 
@@ -137,6 +258,252 @@ TEST_CASE("Validate nested `File` with USDA.JSON files", "[File]") {
     CHECK(lhs_jq_json == rhs_jq_json);
 }
 
+TEST_CASE("Benchmark a full `File` traversal", "[.][benchmark][File]") {
+    using namespace cavi::usdj_am;
+
+    // Run it explicitly, e.g. `cavi_usdj-am_test "[benchmark]"`.
+    // The sample assets are whole files whereas the others hold a scene.
+    auto const INPUT = GENERATE(as<path>{}, ASSETS / "Ball.shadingVariants.usdj-am", ASSETS / "helloWorld.usdj-am",
+                                ASSETS / "relativeReference.usdj-am", ASSETS / "usdPhysicsBoxOnBox.usdj-am",
+                                "brave-ape-49.automerge", "a-cube.automerge", "two-cubes.automerge",
+                                "cube-island.automerge", "foolish-ape-51.automerge");
+    // Fetching each property on demand versus all of a node's at once.
+    auto const MATERIALIZE = GENERATE(false, true);
+    // Freeing each result when its last node is destroyed versus all of them
+    // at the end of the traversal.
+    auto const ARENA = GENERATE(false, true);
+    auto document = utils::Document::load(ROOT / INPUT);
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    std::optional<utils::Item> scene_item;
+    if (INPUT.extension() == ".automerge") {
+        scene_item.emplace(document.get_item() / "data" / "scene");
+    }
+    // Reading every property of every node.
+    auto const traverse = [&]() {
+        std::optional<utils::ResultArena> arena;
+        if (ARENA) {
+            arena.emplace();
+        }
+        auto file = (scene_item) ? File{document, *scene_item} : File{document};
+        utils::JsonWriter json_writer{utils::JsonWriter::Indenter{' ', 2}, utils::JsonWriter::DEFAULT_PRECISION,
+                                      MATERIALIZE};
+        file.accept(json_writer);
+        // The arena's peak is at the end of its scope.
+        return std::make_pair(json_writer.operator std::string().size(), (arena) ? arena->size() : 0);
+    };
+    auto const fetch_count = Node::get_fetch_count();
+    auto const sizes = traverse();
+    CHECK(sizes.first > 0);
+    auto const name = INPUT.stem().string() + (MATERIALIZE ? " (materialized" : " (lazy") + (ARENA ? ", arena)" : ")");
+    std::cout << name << ": " << Node::get_fetch_count() - fetch_count << " property fetches per traversal";
+    if (ARENA) {
+        std::cout << ", " << sizes.second << " results held";
+    }
+    std::cout << std::endl;
+    BENCHMARK(std::string{name}) {
+        return traverse();
+    };
+}
+
+TEST_CASE("Validate materialized `File` traversal", "[File]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "cube-island.automerge");
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    auto const scene_item = document.get_item() / "data" / "scene";
+    auto const write = [&](bool const materialize) {
+        auto file = File{document, scene_item};
+        utils::JsonWriter json_writer{utils::JsonWriter::Indenter{' ', 2}, utils::JsonWriter::DEFAULT_PRECISION,
+                                      materialize};
+        auto const fetch_count = Node::get_fetch_count();
+        file.accept(json_writer);
+        return std::make_pair(json_writer.operator std::string(), Node::get_fetch_count() - fetch_count);
+    };
+    auto const lazy = write(false);
+    auto const materialized = write(true);
+    // The output is the same but it took fewer fetches to produce.
+    CHECK(materialized.first == lazy.first);
+    CHECK(materialized.second < lazy.second);
+}
+
+TEST_CASE("Validate lazy `Node` property caching", "[File]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "cube-island.automerge");
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    auto const scene_item = document.get_item() / "data" / "scene";
+    auto const file = File{document, scene_item};
+    auto const fetch_count = Node::get_fetch_count();
+    auto const size = file.get_statements().size();
+    CHECK(Node::get_fetch_count() == fetch_count + 1);
+    // A second read is served from the property's slot.
+    CHECK(file.get_statements().size() == size);
+    CHECK(Node::get_fetch_count() == fetch_count + 1);
+    // A statement's node reuses the type that named its alternative.
+    auto const statements = file.get_statements();
+    REQUIRE(statements.size() > 0);
+    auto const statement = statements[0];
+    CHECK(Node::get_fetch_count() == fetch_count + 1);
+}
+
+TEST_CASE("Validate `File` traversal within a `ResultArena`", "[utils::ResultArena]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "cube-island.automerge");
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    auto const scene_item = document.get_item() / "data" / "scene";
+    auto const write = [&]() {
+        auto file = File{document, scene_item};
+        utils::JsonWriter json_writer{utils::JsonWriter::Indenter{' ', 2}};
+        file.accept(json_writer);
+        return json_writer.operator std::string();
+    };
+    CHECK(utils::ResultArena::get_current() == nullptr);
+    auto const owned = write();
+    {
+        utils::ResultArena arena;
+        CHECK(utils::ResultArena::get_current() == &arena);
+        CHECK(write() == owned);
+        auto const size = arena.size();
+        CHECK(size > 0);
+        {
+            // Only the innermost arena takes ownership.
+            utils::ResultArena nested;
+            CHECK(utils::ResultArena::get_current() == &nested);
+            CHECK(write() == owned);
+            CHECK(nested.size() == size);
+        }
+        CHECK(utils::ResultArena::get_current() == &arena);
+        CHECK(arena.size() == size);
+    }
+    CHECK(utils::ResultArena::get_current() == nullptr);
+    utils::Document::ResultPtr const list_result{
+        AMmapPutObject(document, AM_ROOT, AMstr("objectDeclarationList"), AM_OBJ_TYPE_MAP), AMresultFree};
+    REQUIRE(AMresultStatus(list_result.get()) == AM_STATUS_OK);
+    AMobjId const* const list_obj_id = AMitemObjId(AMresultItem(list_result.get()));
+    AMresultFree(AMmapPutStr(document, list_obj_id, AMstr("type"), AMstr("objectDeclarationList")));
+    AMresultFree(AMmapPutObject(document, list_obj_id, AMstr("values"), AM_OBJ_TYPE_LIST));
+    auto const file = File{document, scene_item};
+    std::size_t size = 0;
+    {
+        utils::ResultArena arena;
+        // A node created within an arena keeps the property that it validated.
+        auto const list = ObjectDeclarationList{document, AMresultItem(list_result.get())};
+        auto const fetch_count = Node::get_fetch_count();
+        CHECK(list.get_type() == "objectDeclarationList");
+        CHECK(Node::get_fetch_count() == fetch_count);
+        size = file.get_statements().size();
+    }
+    // A node created outside of an arena owns the properties that it read
+    // within one.
+    auto const fetch_count = Node::get_fetch_count();
+    CHECK(file.get_statements().size() == size);
+    CHECK(Node::get_fetch_count() == fetch_count);
+}
+
+TEST_CASE("Validate `ArrayInputRange` chunked and indexed access", "[ArrayInputRange]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "cube-island.automerge");
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    auto const scene_item = document.get_item() / "data" / "scene";
+    auto const file = File{document, scene_item};
+    auto statements = file.get_statements();
+    REQUIRE(statements.size() > 1);
+    auto const write = [](Statement const& statement) {
+        utils::JsonWriter json_writer{utils::JsonWriter::Indenter{' ', 2}};
+        statement.accept(json_writer);
+        return json_writer.operator std::string();
+    };
+    std::vector<std::string> indexed;
+    for (std::size_t index = 0; index != statements.size(); ++index) {
+        indexed.push_back(write(statements[index]));
+    }
+    CHECK_THROWS_AS(statements[statements.size()], std::out_of_range);
+    // Fetching one element at a time, in chunks smaller than the array and in
+    // chunks larger than it.
+    auto const CHUNK_SIZE =
+        GENERATE(std::size_t{0}, std::size_t{1}, std::size_t{3}, ArrayInputRange<Statement>::DEFAULT_CHUNK_SIZE);
+    statements.set_chunk_size(CHUNK_SIZE);
+    std::vector<std::string> iterated;
+    for (auto const& statement : statements) {
+        iterated.push_back(write(statement));
+    }
+    CHECK(iterated == indexed);
+    // An iterator equals the end once it's past the last element.
+    auto iter = statements.begin();
+    for (std::size_t index = 0; index != statements.size(); ++index) {
+        CHECK(iter != statements.end());
+        ++iter;
+    }
+    CHECK(iter == statements.end());
+}
+
+TEST_CASE("Validate `SceneChanges` decoding", "[SceneChanges]") {
+    using namespace cavi::usdj_am;
+
+    auto document = utils::Document::load(ROOT / "a-cube.automerge");
+    CHECK(document != static_cast<AMdoc*>(nullptr));
+    auto const scene_item = document.get_item("/data/scene");
+    auto const parent_item = document.get_item("/data/scene/statements/0");
+    auto const parent_statements_item = document.get_item("/data/scene/statements/0/statements");
+    auto const cube_item = document.get_item("/data/scene/statements/0/statements/0");
+    auto const cube_statements_item = document.get_item("/data/scene/statements/0/statements/0/statements");
+    auto const rotate_item = document.get_item("/data/scene/statements/0/statements/0/statements/0");
+    auto const order_item = document.get_item("/data/scene/statements/0/statements/0/statements/3");
+    AMobjId const* const cube_obj_id = AMitemObjId(cube_item);
+    auto index = SceneIndex{document, scene_item};
+    std::vector<utils::Document::ResultPtr> heads;
+    heads.emplace_back(AMgetHeads(document), AMresultFree);
+    // Applies a change and then decodes it.
+    auto const decode = [&](AMresult* const change_result) {
+        utils::Document::ResultPtr const result{change_result, AMresultFree};
+        CHECK(AMresultStatus(result.get()) == AM_STATUS_OK);
+        heads.emplace_back(AMgetHeads(document), AMresultFree);
+        AMitems const before_heads = AMresultItems(heads[heads.size() - 2].get());
+        AMitems const after_heads = AMresultItems(heads.back().get());
+        return SceneChanges{index, utils::Operations{document, &before_heads, &after_heads}, &after_heads};
+    };
+    // A change outside of the scene.
+    auto changes = decode(AMmapPutInt(document, AM_ROOT, AMstr("presence"), 1));
+    CHECK(changes.empty());
+    // A change to an ordinary declaration.
+    changes = decode(AMmapPutInt(document, AMitemObjId(rotate_item), AMstr("presence"), 1));
+    REQUIRE(changes.size() == 1);
+    CHECK(changes.begin()->type == SceneChangeType::DECLARATION_CHANGED);
+    CHECK(AMobjIdEqual(changes.begin()->object_id, cube_obj_id));
+    CHECK(changes.begin()->identifier == "xformOp:rotateXYZ");
+    // A change to the "xformOpOrder" declaration.
+    changes = decode(AMmapPutInt(document, AMitemObjId(order_item), AMstr("presence"), 1));
+    REQUIRE(changes.size() == 1);
+    CHECK(changes.begin()->type == SceneChangeType::XFORM_OP_ORDER_CHANGED);
+    CHECK(AMobjIdEqual(changes.begin()->object_id, cube_obj_id));
+    // A change to a definition itself.
+    changes = decode(AMmapPutInt(document, cube_obj_id, AMstr("presence"), 1));
+    REQUIRE(changes.size() == 1);
+    CHECK(changes.begin()->type == SceneChangeType::DEFINITION_CHANGED);
+    CHECK(AMobjIdEqual(changes.begin()->object_id, cube_obj_id));
+    // A change within an object that was made since the index was built.
+    changes = decode(AMmapPutObject(document, AMitemObjId(rotate_item), AMstr("extra"), AM_OBJ_TYPE_MAP));
+    REQUIRE(changes.size() == 1);
+    auto const extra_item = document.get_item("/data/scene/statements/0/statements/0/statements/0/extra");
+    changes = decode(AMmapPutInt(document, AMitemObjId(extra_item), AMstr("presence"), 1));
+    REQUIRE(changes.size() == 1);
+    CHECK(changes.begin()->type == SceneChangeType::DECLARATION_CHANGED);
+    CHECK(changes.begin()->identifier == "xformOp:rotateXYZ");
+    // A deleted declaration.
+    changes = decode(AMlistDelete(document, AMitemObjId(cube_statements_item), 0));
+    REQUIRE(changes.size() == 1);
+    CHECK(changes.begin()->type == SceneChangeType::DECLARATION_CHANGED);
+    CHECK(AMobjIdEqual(changes.begin()->object_id, cube_obj_id));
+    CHECK(changes.begin()->identifier == "xformOp:rotateXYZ");
+    // A deleted definition.
+    changes = decode(AMlistDelete(document, AMitemObjId(parent_statements_item), 0));
+    REQUIRE(changes.size() == 1);
+    CHECK(changes.begin()->type == SceneChangeType::PRIM_REMOVED);
+    CHECK(AMobjIdEqual(changes.begin()->object_id, AMitemObjId(parent_item)));
+}
+
 TEST_CASE("Validate `Item` path parsing with key leaf", "[utils::Item]") {
     using namespace cavi::usdj_am;
 
@@ -0,0 +1,98 @@
+/**************************************************************************/
+/* usdj_body_pool.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <utility>
+
+// regional
+#include <core/os/memory.h>
+
+// local
+#include "usdj_body_pool.h"
+
+UsdjBodyPool::UsdjBodyPool(std::size_t const p_high_water_mark)
+    : m_high_water_mark{p_high_water_mark}, m_hit_count{0}, m_miss_count{0}, m_size{0} {}
+
+UsdjBodyPool::~UsdjBodyPool() {
+    clear();
+}
+
+UsdjBodyPool::Body* UsdjBodyPool::acquire(cavi::usdj_am::Definition&& p_definition) {
+    auto const kind = UsdjGeometryExtractor{p_definition}.get_kind();
+    if (kind) {
+        auto const match = m_bodies.find(*kind);
+        if (match != m_bodies.end() && !match->second.empty()) {
+            auto const body = match->second.back();
+            match->second.pop_back();
+            --m_size;
+            ++m_hit_count;
+            body->recycle(std::move(p_definition));
+            return body;
+        }
+    }
+    ++m_miss_count;
+    return memnew(Body{std::move(p_definition)});
+}
+
+void UsdjBodyPool::clear() {
+    for (auto& entry : m_bodies) {
+        for (auto const body : entry.second) {
+            memdelete(body);
+        }
+    }
+    m_bodies.clear();
+    m_size = 0;
+}
+
+void UsdjBodyPool::release(Body* const p_body) {
+    if (!p_body)
+        return;
+    auto const kind = p_body->get_kind();
+    if (!kind || m_size >= m_high_water_mark) {
+        memdelete(p_body);
+        return;
+    }
+    p_body->retire();
+    m_bodies[*kind].push_back(p_body);
+    ++m_size;
+}
+
+void UsdjBodyPool::set_high_water_mark(std::size_t const p_high_water_mark) {
+    m_high_water_mark = p_high_water_mark;
+    trim();
+}
+
+void UsdjBodyPool::trim() {
+    for (auto& entry : m_bodies) {
+        while (m_size > m_high_water_mark && !entry.second.empty()) {
+            memdelete(entry.second.back());
+            entry.second.pop_back();
+            --m_size;
+        }
+    }
+}
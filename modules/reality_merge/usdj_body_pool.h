@@ -0,0 +1,132 @@
+/**************************************************************************/
+/* usdj_body_pool.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_BODY_POOL_H
+#define REALITY_MERGE_USDJ_BODY_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// third-party
+#include <cavi/usdj_am/definition.hpp>
+
+// local
+#include "usdj_geometry_extractor.h"
+#include "usdj_static_body_3d.h"
+
+/// \brief A pool of detached physics bodies that can be reused to represent
+///        USD prims with the same kind of geometry.
+class UsdjBodyPool {
+public:
+    using Body = UsdjStaticBody3D;
+
+    /// \brief The default count of bodies above which released ones are
+    ///        freed instead of pooled.
+    static std::size_t const HIGH_WATER_MARK = 256;
+
+    /// \param[in] p_high_water_mark The count of bodies above which released
+    ///                              ones are freed instead of pooled.
+    UsdjBodyPool(std::size_t const p_high_water_mark = HIGH_WATER_MARK);
+
+    UsdjBodyPool(UsdjBodyPool const&) = delete;
+
+    UsdjBodyPool(UsdjBodyPool&&) = delete;
+
+    /// \brief Frees the pooled bodies.
+    ~UsdjBodyPool();
+
+    UsdjBodyPool& operator=(UsdjBodyPool const&) = delete;
+
+    UsdjBodyPool& operator=(UsdjBodyPool&&) = delete;
+
+    /// \brief Takes a pooled body with the same kind of geometry as the given
+    ///        "USDA_Definition" or constructs a new one.
+    ///
+    /// \param[in] p_definition A "USDA_Definition" node.
+    /// \returns A pointer to a body that isn't inside the scene tree.
+    /// \throws std::invalid_argument
+    Body* acquire(cavi::usdj_am::Definition&& p_definition);
+
+    /// \brief Frees all of the pooled bodies.
+    void clear();
+
+    /// \returns The count of bodies above which released ones are freed
+    ///          instead of pooled.
+    std::size_t get_high_water_mark() const;
+
+    /// \returns The count of bodies that were taken from the pool.
+    std::uint64_t get_hit_count() const;
+
+    /// \returns The count of bodies that had to be constructed.
+    std::uint64_t get_miss_count() const;
+
+    /// \brief Pools a body that was removed from the scene tree or frees it if
+    ///        the pool is full.
+    ///
+    /// \param[in] p_body A pointer to a body that isn't inside the scene tree.
+    void release(Body* const p_body);
+
+    /// \param[in] p_high_water_mark A count of bodies above which released ones
+    ///                              are freed instead of pooled.
+    void set_high_water_mark(std::size_t const p_high_water_mark);
+
+    /// \returns The count of pooled bodies.
+    std::size_t size() const;
+
+private:
+    /// \brief Frees pooled bodies until there are no more than the high-water
+    ///        mark.
+    void trim();
+
+    std::map<UsdjGeometryExtractor::Kind, std::vector<Body*>> m_bodies;
+    std::size_t m_high_water_mark;
+    std::uint64_t m_hit_count;
+    std::uint64_t m_miss_count;
+    std::size_t m_size;
+};
+
+inline std::size_t UsdjBodyPool::get_high_water_mark() const {
+    return m_high_water_mark;
+}
+
+inline std::uint64_t UsdjBodyPool::get_hit_count() const {
+    return m_hit_count;
+}
+
+inline std::uint64_t UsdjBodyPool::get_miss_count() const {
+    return m_miss_count;
+}
+
+inline std::size_t UsdjBodyPool::size() const {
+    return m_size;
+}
+
+#endif  // REALITY_MERGE_USDJ_BODY_POOL_H
@@ -27,8 +27,8 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
-#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -51,28 +51,103 @@ extern "C" {
 // regional
 #include <core/error/error_macros.h>
 #include <core/object/object.h>
-#include <core/os/memory.h>
 #include <core/string/ustring.h>
 
 // local
+#include "usdj_body_pool.h"
 #include "usdj_body_updater.h"
+#include "usdj_prim_representation.h"
 #include "usdj_static_body_3d.h"
 
-UsdjBodyUpdater::UsdjBodyUpdater(TypedArray<Node> const& nodes) : m_visited_default_prim{false} {
-    for (int pos = 0; pos != nodes.size(); ++pos) {
-        auto const body = Object::cast_to<Body>(nodes[pos]);
-        if (body)
-            m_bodies.push_back(body);
+namespace {
+
+/// \brief Encodes an object ID as a string that is stable across loads of
+///        the same Automerge document.
+///
+/// \param[in] object_id A pointer to an object ID.
+/// \returns The object's counter followed by its actor ID's bytes.
+std::string encode(AMobjId const* const object_id) {
+    std::string key;
+    if (object_id) {
+        auto const counter = static_cast<std::uint64_t>(AMobjIdCounter(object_id));
+        key.append(reinterpret_cast<char const*>(&counter), sizeof(counter));
+        auto const actor_id = AMactorIdBytes(AMobjIdActorId(object_id));
+        key.append(reinterpret_cast<char const*>(actor_id.src), actor_id.count);
+    }
+    return key;
+}
+
+/// \returns The physics body with the given ID or `nullptr` if it has been
+///          freed.
+UsdjBodyUpdater::Body* find_body(ObjectID const& id) {
+    return Object::cast_to<UsdjBodyUpdater::Body>(ObjectDB::get_instance(id));
+}
+
+}  // namespace
+
+UsdjBodyUpdater::Bodies& UsdjBodyUpdater::Updates::operator[](Action const action) {
+    return m_bodies[static_cast<std::size_t>(action) - static_cast<std::size_t>(Action::BEGIN__)];
+}
+
+UsdjBodyUpdater::Bodies const& UsdjBodyUpdater::Updates::operator[](Action const action) const {
+    return m_bodies[static_cast<std::size_t>(action) - static_cast<std::size_t>(Action::BEGIN__)];
+}
+
+void UsdjBodyUpdater::Updates::clear() {
+    for (auto& bodies : m_bodies) {
+        bodies.clear();
+    }
+    m_deferrals.clear();
+}
+
+bool UsdjBodyUpdater::Updates::empty() const {
+    for (auto const& bodies : m_bodies) {
+        if (!bodies.empty())
+            return false;
     }
+    return m_deferrals.empty();
+}
+
+UsdjBodyUpdater::Deferrals& UsdjBodyUpdater::Updates::get_deferrals() {
+    return m_deferrals;
 }
 
+UsdjBodyUpdater::UsdjBodyUpdater(Index& index,
+                                 UsdjBodyPool& pool,
+                                 bool const defer,
+                                 UsdjPrimRepresentation* const representation)
+    : m_defer{defer}, m_index{index}, m_pool{pool}, m_representation{representation}, m_visited_default_prim{false} {}
+
 UsdjBodyUpdater::~UsdjBodyUpdater() {}
 
+UsdjBodyUpdater::Body* UsdjBodyUpdater::find(Index const& index, AMobjId const* const object_id) {
+    auto const match = index.find(encode(object_id));
+    return (match != index.end()) ? find_body(match->second) : nullptr;
+}
+
+std::string UsdjBodyUpdater::make_key(AMobjId const* const object_id) {
+    return encode(object_id);
+}
+
+UsdjBodyUpdater::Index UsdjBodyUpdater::make_index(TypedArray<Node> const& nodes) {
+    Index index;
+    for (int pos = 0; pos != nodes.size(); ++pos) {
+        auto const body = Object::cast_to<Body>(nodes[pos]);
+        if (body && body->get_object_id())
+            index.emplace(encode(body->get_object_id()), body->get_instance_id());
+    }
+    return index;
+}
+
 UsdjBodyUpdater::Updates UsdjBodyUpdater::operator()(cavi::usdj_am::utils::Document const& document,
                                                      std::string const& path) {
     using cavi::usdj_am::File;
 
     m_updates.clear();
+    // Every indexed body must be revisited to remain in the index.
+    m_unvisited = std::move(m_index);
+    m_index.clear();
+    m_index.reserve(m_unvisited.size());
     try {
         auto const file = File{document, document.get_item(path)};
         file.accept(*this);
@@ -82,12 +157,12 @@ UsdjBodyUpdater::Updates UsdjBodyUpdater::operator()(cavi::usdj_am::utils::Docum
     }
     // Any remaining bodies should be removed because they originated
     // from expired USD prims.
-    while (!m_bodies.empty()) {
-        auto const body = m_bodies.front();
-        m_updates.insert(Updates::value_type{Action::REMOVE, body});
-        m_bodies.pop_front();
+    for (auto const& entry : m_unvisited) {
+        if (auto const body = find_body(entry.second))
+            m_updates[Action::REMOVE].push_back(body);
     }
-    return m_updates;
+    m_unvisited.clear();
+    return std::move(m_updates);
 }
 
 void UsdjBodyUpdater::visit(cavi::usdj_am::Assignment const& assignment) {
@@ -127,17 +202,26 @@ void UsdjBodyUpdater::visit(cavi::usdj_am::Definition const& definition) {
     if (!descriptor) {
         return;
     }
-    auto const body_id = definition.get_object_id();
-    auto const match = std::find_if(m_bodies.begin(), m_bodies.end(), [body_id](auto const& body) {
-        auto const static_body_3d = dynamic_cast<UsdjStaticBody3D*>(body);
-        return static_body_3d && AMobjIdEqual(static_body_3d->get_object_id(), body_id);
-    });
-    if (match == m_bodies.end()) {
-        auto const usd_body = memnew(UsdjStaticBody3D{std::move(m_definition.value())});
-        m_updates.insert({Action::ADD, usd_body});
+    auto key = encode(definition.get_object_id());
+    if (m_representation && m_representation->visit(key, m_definition.value())) {
+        // Any physics body that represented the USD prim will be removed.
+        return;
+    }
+    auto const match = m_unvisited.find(key);
+    auto const body = (match != m_unvisited.end()) ? find_body(match->second) : nullptr;
+    if (match != m_unvisited.end())
+        m_unvisited.erase(match);
+    if (!body && m_defer) {
+        // The caller will construct the body later.
+        m_index.emplace(key, ObjectID{});
+        m_updates.get_deferrals().push_back(Deferral{std::move(key), std::move(m_definition.value())});
+    } else if (!body) {
+        auto const usd_body = m_pool.acquire(std::move(m_definition.value()));
+        m_index.emplace(std::move(key), usd_body->get_instance_id());
+        m_updates[Action::ADD].push_back(usd_body);
     } else {
-        m_updates.insert({Action::KEEP, *match});
-        m_bodies.erase(match);
+        m_index.emplace(std::move(key), body->get_instance_id());
+        m_updates[Action::KEEP].push_back(body);
     }
 }
 
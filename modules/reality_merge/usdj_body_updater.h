@@ -30,22 +30,26 @@
 #ifndef REALITY_MERGE_USDJ_BODY_UPDATER_H
 #define REALITY_MERGE_USDJ_BODY_UPDATER_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <list>
-#include <map>
-#include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // third-party
 #include <cavi/usdj_am/definition.hpp>
 #include <cavi/usdj_am/visitor.hpp>
 
 // regional
+#include <core/object/object_id.h>
 #include <core/typedefs.h>
 #include <core/variant/typed_array.h>
 
 // local
+#include "usdj_body_pool.h"
+#include "usdj_prim_representation.h"
 #include "usdj_static_body_3d.h"
 
 namespace cavi {
@@ -64,14 +68,61 @@ public:
 
     enum class Action : std::uint8_t { BEGIN__ = 1, ADD = BEGIN__, KEEP, REMOVE, END__, SIZE__ = END__ - BEGIN__ };
 
-    using Updates = std::multimap<Action, Body*>;
+    using Bodies = std::vector<Body*>;
+
+    /// \brief A map of the encoded object IDs of USD prims to the IDs of the
+    ///        physics bodies that represent them.
+    using Index = std::unordered_map<std::string, ObjectID>;
+
+    /// \brief A USD prim whose physics body's construction was deferred.
+    struct Deferral {
+        /// \brief The prim's encoded object ID within the index.
+        std::string key;
+        cavi::usdj_am::Definition definition;
+    };
+
+    using Deferrals = std::vector<Deferral>;
+
+    /// \brief Physics bodies sorted into categories of actions.
+    class Updates {
+    public:
+        Bodies& operator[](Action const action);
+
+        Bodies const& operator[](Action const action) const;
+
+        void clear();
+
+        bool empty() const;
+
+        /// \returns The USD prims whose physics bodies have yet to be
+        ///          constructed.
+        Deferrals& get_deferrals();
+
+    private:
+        std::array<Bodies, static_cast<std::size_t>(Action::SIZE__)> m_bodies;
+        Deferrals m_deferrals;
+    };
 
     UsdjBodyUpdater() = delete;
 
-    /// \brief Borrows nodes that represent physics bodies within a scene.
+    /// \brief Borrows an index of the physics bodies within a scene.
     ///
-    /// \param[in] nodes An array of child nodes in a scene node.
-    UsdjBodyUpdater(TypedArray<Node> const& nodes);
+    /// \param[in,out] index An index that will be revised to match the
+    ///                      physics bodies described by the USDJ.
+    /// \param[in,out] pool A pool from which new physics bodies are taken.
+    /// \param[in] defer Whether to defer the construction of new physics
+    ///                  bodies to the caller.
+    /// \param[in,out] representation An optional representation of the USD
+    ///                               prims that don't need physics body
+    ///                               nodes.
+    /// \note The index maps the USD prims of deferred physics bodies to null
+    ///       IDs.
+    /// \note The USD prims represented by \p representation aren't
+    ///       indexed.
+    UsdjBodyUpdater(Index& index,
+                    UsdjBodyPool& pool,
+                    bool const defer = false,
+                    UsdjPrimRepresentation* const representation = nullptr);
 
     UsdjBodyUpdater(UsdjBodyUpdater const&) = delete;
 
@@ -81,14 +132,34 @@ public:
 
     UsdjBodyUpdater& operator=(UsdjBodyUpdater const&) = delete;
 
-    UsdjBodyUpdater& operator=(UsdjBodyUpdater&&) = default;
+    UsdjBodyUpdater& operator=(UsdjBodyUpdater&&) = delete;
+
+    /// \brief Finds the physics body that represents a USD prim.
+    ///
+    /// \param[in] index An index of physics bodies.
+    /// \param[in] object_id A pointer to the ID of a "USDA_Definition" node.
+    /// \returns A pointer to a physics body or `nullptr`.
+    static Body* find(Index const& index, AMobjId const* const object_id);
+
+    /// \brief Encodes the object ID of a USD prim as a key of an index.
+    ///
+    /// \param[in] object_id A pointer to the ID of a "USDA_Definition" node.
+    /// \returns A key that is stable across loads of the same Automerge
+    ///          document.
+    static std::string make_key(AMobjId const* const object_id);
 
-    /// \brief Creates new physics bodies and sorts pre-existing ones into
-    ///        categories of forgotten, kept and removed.
+    /// \brief Indexes the nodes that represent physics bodies within a scene.
+    ///
+    /// \param[in] nodes An array of child nodes in a scene node.
+    /// \returns An index of the physics bodies within \p nodes.
+    static Index make_index(TypedArray<Node> const& nodes);
+
+    /// \brief Creates or defers new physics bodies and sorts pre-existing
+    ///        ones into categories of kept and removed.
     ///
     /// \param[in] document An Automerge document.
     /// \param[in] path A POSIX path to a "USDA_File" node within \p document.
-    /// \returns A multimap of categories to physics bodies.
+    /// \returns The physics bodies sorted into categories of actions.
     Updates operator()(cavi::usdj_am::utils::Document const& document, std::string const& path);
 
     void visit(cavi::usdj_am::Assignment const& assignment) override;
@@ -104,11 +175,14 @@ public:
     void visit(cavi::usdj_am::Statement&& statement) override;
 
 private:
-    using Bodies = std::list<Body*>;
-
-    Bodies m_bodies;
     std::optional<std::string> m_default_prim;
+    bool m_defer;
     std::optional<cavi::usdj_am::Definition> m_definition;
+    Index& m_index;
+    UsdjBodyPool& m_pool;
+    UsdjPrimRepresentation* m_representation;
+    /// \brief The entries of the index that haven't been visited yet.
+    Index m_unvisited;
     Updates m_updates;
     bool m_visited_default_prim;
 };
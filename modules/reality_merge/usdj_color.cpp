@@ -46,11 +46,12 @@ Color to_Color(cavi::usdj_am::Value const& value) {
     Color result{};
     try {
         auto const& values = std::get<ValueRange>(value);
-        if (values.size() == 1) {
+        auto const size = values.size();
+        if (size == 1) {
             // It may be a nested array.
-            result = to_Color(*values.begin());
-        } else if (values.size() < 3 || values.size() > 4) {
-            args << "std::get<" << typeid(decltype(values)).name() << ">(value).size() == " << values.size();
+            result = to_Color(values[0]);
+        } else if (size < 3 || size > 4) {
+            args << "std::get<" << typeid(decltype(values)).name() << ">(value).size() == " << size;
         } else {
             auto component = std::begin(result.components);
             for (auto const& value : values) {
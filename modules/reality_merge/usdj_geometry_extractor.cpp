@@ -42,17 +42,17 @@
 #include <cavi/usdj_am/usd/token_type.hpp>
 
 // regional
+#include <core/math/vector3.h>
 #include <core/object/ref_counted.h>
-#include <core/os/memory.h>
 #include <scene/resources/box_shape_3d.h>
-#include <scene/resources/material.h>
 #include <scene/resources/primitive_meshes.h>
 
 // local
 #include "usdj_geometry_extractor.h"
+#include "usdj_resource_cache.h"
 
 UsdjGeometryExtractor::UsdjGeometryExtractor(cavi::usdj_am::Definition const& p_definition)
-    : m_definition{p_definition} {}
+    : m_definition{p_definition}, m_extracted{false} {}
 
 UsdjGeometryExtractor::~UsdjGeometryExtractor() {}
 
@@ -60,28 +60,54 @@ std::pair<UsdjGeometryExtractor::MeshPtr, UsdjGeometryExtractor::Shape3dPtr> Usd
     namespace geom = cavi::usdj_am::usd::geom;
     namespace physics = cavi::usdj_am::usd::physics;
 
-    m_definition.accept(*this);
     std::pair<MeshPtr, Shape3dPtr> geometry{};
-    // Assign the mesh.
-    switch (m_geom_type.value_or(geom::TokenType{})) {
+    auto const kind = get_kind();
+    if (!kind)
+        return geometry;
+    // Share the mesh with the other bodies of the same default size. Its
+    // material is assigned per body because the mesh is shared.
+    switch (kind->first) {
         case geom::TokenType::CUBE: {
-            geometry.first = Ref<BoxMesh>{memnew(BoxMesh)};
-            if (m_physics_apis.count(physics::TokenType::PHYSICS_COLLISION_API)) {
-                geometry.second = Shape3dPtr{memnew(BoxShape3D)};
+            static Vector3 const SIZE{1.0, 1.0, 1.0};
+
+            auto const resource_cache = UsdjResourceCache::get_singleton();
+            geometry.first = resource_cache->get_box_mesh(SIZE);
+            if (kind->second) {
+                geometry.second = resource_cache->get_box_shape(SIZE);
             }
             break;
         }
             /// \todo Handle other types of gprim.
-    }
-    if (!geometry.first.is_null()) {
-        // Assign material to the surface(s).
-        /// \todo Handle multiple surfaces.
-        auto const material = Ref<BaseMaterial3D>{memnew(BaseMaterial3D{false})};
-        geometry.first->surface_set_material(0, material);
+        default: {
+            break;
+        }
     }
     return geometry;
 }
 
+void UsdjGeometryExtractor::extract() {
+    if (!m_extracted) {
+        m_definition.accept(*this);
+        m_extracted = true;
+    }
+}
+
+std::optional<UsdjGeometryExtractor::Kind> UsdjGeometryExtractor::get_kind() {
+    namespace geom = cavi::usdj_am::usd::geom;
+    namespace physics = cavi::usdj_am::usd::physics;
+
+    extract();
+    switch (m_geom_type.value_or(geom::TokenType{})) {
+        case geom::TokenType::CUBE: {
+            return Kind{*m_geom_type, m_physics_apis.count(physics::TokenType::PHYSICS_COLLISION_API) != 0};
+        }
+            /// \todo Handle other types of gprim.
+        default: {
+            return std::nullopt;
+        }
+    }
+}
+
 void UsdjGeometryExtractor::visit(cavi::usdj_am::Assignment const& assignment) {
     using cavi::usdj_am::AssignmentKeyword;
     using cavi::usdj_am::ExternalReference;
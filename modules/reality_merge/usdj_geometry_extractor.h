@@ -50,6 +50,9 @@ struct Vector3;
 ///        within a "USDA_Definition" node.
 class UsdjGeometryExtractor : public cavi::usdj_am::Visitor {
 public:
+    /// \brief A kind of geometry as a type of gprim and whether it has a
+    ///        collision shape.
+    using Kind = std::pair<cavi::usdj_am::usd::geom::TokenType, bool>;
     using MeshPtr = Ref<Mesh>;
     using Shape3dPtr = Ref<Shape3D>;
 
@@ -69,6 +72,10 @@ public:
 
     std::pair<MeshPtr, Shape3dPtr> operator()();
 
+    /// \returns The kind of geometry that would be extracted or
+    ///          `std::nullopt` if there would be no mesh.
+    std::optional<Kind> get_kind();
+
     void visit(cavi::usdj_am::Assignment const& assignment) override;
 
     void visit(cavi::usdj_am::Definition const& definition) override;
@@ -80,7 +87,11 @@ public:
     void visit(cavi::usdj_am::ReferenceFile const& reference_file) override;
 
 private:
+    /// \brief Visits the "USDA_Definition" node unless it already has been.
+    void extract();
+
     cavi::usdj_am::Definition const& m_definition;
+    bool m_extracted;
     std::optional<cavi::usdj_am::usd::geom::TokenType> m_geom_type;
     cavi::usdj_am::usd::physics::TokenTypeSet m_physics_apis;
 };
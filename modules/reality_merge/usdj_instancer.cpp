@@ -0,0 +1,264 @@
+/**************************************************************************/
+/* usdj_instancer.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <algorithm>
+#include <utility>
+
+// regional
+#include <core/math/vector3.h>
+#include <core/object/object.h>
+#include <core/os/memory.h>
+#include <core/string/string_name.h>
+#include <scene/3d/multimesh_instance_3d.h>
+#include <scene/main/node.h>
+#include <scene/resources/material.h>
+#include <scene/resources/multimesh.h>
+
+// local
+#include "usdj_geometry_extractor.h"
+#include "usdj_instancer.h"
+#include "usdj_prim_extractor.h"
+#include "usdj_resource_cache.h"
+
+namespace {
+
+/// \brief The least count of instances for which a batch has room.
+constexpr std::size_t const MIN_CAPACITY = 16;
+
+}  // namespace
+
+UsdjInstancer::UsdjInstancer() {}
+
+UsdjInstancer::~UsdjInstancer() {
+    clear();
+}
+
+void UsdjInstancer::begin_pass(Node* const p_parent, bool const p_stale) {
+    auto const parent_id = (p_parent) ? p_parent->get_instance_id() : ObjectID{};
+    if (parent_id != m_parent_id) {
+        // The batches belong to the previous parent.
+        clear();
+        m_parent_id = parent_id;
+    }
+    for (auto& entry : m_instances) {
+        entry.second.stale = entry.second.stale || p_stale;
+        entry.second.visited = false;
+    }
+}
+
+void UsdjInstancer::clear() {
+    m_instances.clear();
+    for (auto const& entry : m_batches) {
+        if (Node* const node = Object::cast_to<Node>(ObjectDB::get_instance(entry.second.node_id))) {
+            if (node->is_inside_tree()) {
+                node->queue_free();
+            } else {
+                // Free it after its deferred addition to the parent.
+                node->call_deferred(SNAME("queue_free"));
+            }
+        }
+    }
+    m_batches.clear();
+}
+
+bool UsdjInstancer::contains(std::string const& p_key) const {
+    return m_instances.count(p_key) != 0;
+}
+
+void UsdjInstancer::end_pass() {
+    for (auto iter = m_instances.begin(); iter != m_instances.end();) {
+        if (!iter->second.visited) {
+            // The USD prim has expired.
+            if (iter->second.batch_key)
+                vacate(iter->second);
+            iter = m_instances.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+std::size_t UsdjInstancer::get_batch_count() const {
+    return m_batches.size();
+}
+
+UsdjInstancer::Batch& UsdjInstancer::get_batch(BatchKey const& p_batch_key) {
+    namespace geom = cavi::usdj_am::usd::geom;
+
+    auto const match = m_batches.find(p_batch_key);
+    if (match != m_batches.end())
+        return match->second;
+    Batch batch{};
+    batch.multi_mesh.instantiate();
+    batch.multi_mesh->set_transform_format(MultiMesh::TRANSFORM_3D);
+    batch.multi_mesh->set_use_colors(true);
+    switch (p_batch_key.first) {
+        case geom::TokenType::CUBE: {
+            batch.multi_mesh->set_mesh(UsdjResourceCache::get_singleton()->get_box_mesh(Vector3{1.0, 1.0, 1.0}));
+            break;
+        }
+            /// \todo Handle other types of gprim.
+        default: {
+            break;
+        }
+    }
+    // The instances' colors are their albedos.
+    auto const material = Ref<BaseMaterial3D>{memnew(BaseMaterial3D{false})};
+    material->set_flag(BaseMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+    if (p_batch_key.second)
+        material->set_transparency(BaseMaterial3D::TRANSPARENCY_ALPHA);
+    auto const node = memnew(MultiMeshInstance3D);
+    node->set_multimesh(batch.multi_mesh);
+    node->set_material_override(material);
+    if (Node* const parent = Object::cast_to<Node>(ObjectDB::get_instance(m_parent_id))) {
+        batch.node_id = node->get_instance_id();
+        // The parent may be busy setting up its children.
+        parent->call_deferred(SNAME("add_child"), node);
+    } else {
+        memdelete(node);
+    }
+    return m_batches.emplace(p_batch_key, std::move(batch)).first->second;
+}
+
+void UsdjInstancer::invalidate(std::string const& p_key) {
+    auto const match = m_instances.find(p_key);
+    if (match != m_instances.end())
+        match->second.stale = true;
+}
+
+bool UsdjInstancer::place(std::string const& p_key, Instance& p_instance) {
+    auto const kind = UsdjGeometryExtractor{p_instance.definition}.get_kind();
+    // A collision shape is needed for physics and picking.
+    if (!kind || kind->second)
+        return false;
+    auto const properties = UsdjPrimExtractor{p_instance.definition}();
+    auto const color = properties.get_albedo().value_or(Color{1.0, 1.0, 1.0});
+    auto transform = properties.transform.value_or(Transform3D{});
+    if (properties.size)
+        transform = transform.scaled_local(*properties.size);
+    auto const batch_key = BatchKey{kind->first, color.a < 1.0};
+    if (p_instance.batch_key == batch_key) {
+        // Update the instance in place.
+        auto& batch = m_batches.at(batch_key);
+        auto const slot = static_cast<int>(p_instance.slot);
+        if (batch.transforms[p_instance.slot] != transform) {
+            batch.transforms[p_instance.slot] = transform;
+            batch.multi_mesh->set_instance_transform(slot, transform);
+        }
+        if (batch.colors[p_instance.slot] != color) {
+            batch.colors[p_instance.slot] = color;
+            batch.multi_mesh->set_instance_color(slot, color);
+        }
+    } else {
+        if (p_instance.batch_key)
+            vacate(p_instance);
+        auto& batch = get_batch(batch_key);
+        p_instance.batch_key.emplace(batch_key);
+        p_instance.slot = batch.keys.size();
+        batch.keys.push_back(p_key);
+        batch.transforms.push_back(transform);
+        batch.colors.push_back(color);
+        auto const count = batch.keys.size();
+        if (count > static_cast<std::size_t>(batch.multi_mesh->get_instance_count())) {
+            // Resizing the buffer clears it so all of its instances must be
+            // set again.
+            batch.multi_mesh->set_instance_count(static_cast<int>(std::max(MIN_CAPACITY, count * 2)));
+            for (std::size_t slot = 0; slot != count; ++slot) {
+                batch.multi_mesh->set_instance_transform(static_cast<int>(slot), batch.transforms[slot]);
+                batch.multi_mesh->set_instance_color(static_cast<int>(slot), batch.colors[slot]);
+            }
+        } else {
+            batch.multi_mesh->set_instance_transform(static_cast<int>(p_instance.slot), transform);
+            batch.multi_mesh->set_instance_color(static_cast<int>(p_instance.slot), color);
+        }
+        batch.multi_mesh->set_visible_instance_count(static_cast<int>(count));
+    }
+    p_instance.stale = false;
+    return true;
+}
+
+bool UsdjInstancer::revise(std::string const& p_key) {
+    auto const match = m_instances.find(p_key);
+    if (match == m_instances.end())
+        return false;
+    if (place(p_key, match->second))
+        return true;
+    if (match->second.batch_key)
+        vacate(match->second);
+    m_instances.erase(match);
+    return false;
+}
+
+std::size_t UsdjInstancer::size() const {
+    return m_instances.size();
+}
+
+void UsdjInstancer::vacate(Instance const& p_instance) {
+    auto& batch = m_batches.at(*p_instance.batch_key);
+    auto const slot = p_instance.slot;
+    auto const last = batch.keys.size() - 1;
+    if (slot != last) {
+        batch.keys[slot] = std::move(batch.keys[last]);
+        batch.transforms[slot] = batch.transforms[last];
+        batch.colors[slot] = batch.colors[last];
+        batch.multi_mesh->set_instance_transform(static_cast<int>(slot), batch.transforms[slot]);
+        batch.multi_mesh->set_instance_color(static_cast<int>(slot), batch.colors[slot]);
+        m_instances.at(batch.keys[slot]).slot = slot;
+    }
+    batch.keys.pop_back();
+    batch.transforms.pop_back();
+    batch.colors.pop_back();
+    batch.multi_mesh->set_visible_instance_count(static_cast<int>(batch.keys.size()));
+}
+
+bool UsdjInstancer::visit(std::string const& p_key, cavi::usdj_am::Definition& p_definition) {
+    auto const match = m_instances.find(p_key);
+    if (match != m_instances.end()) {
+        auto& instance = match->second;
+        instance.visited = true;
+        if (!instance.stale)
+            return true;
+        instance.definition = std::move(p_definition);
+        if (place(p_key, instance))
+            return true;
+        // The USD prim needs a physics body now.
+        p_definition = std::move(instance.definition);
+        if (instance.batch_key)
+            vacate(instance);
+        m_instances.erase(match);
+        return false;
+    }
+    auto& instance =
+        m_instances.emplace(p_key, Instance{std::nullopt, 0, std::move(p_definition), true, true}).first->second;
+    if (place(p_key, instance))
+        return true;
+    p_definition = std::move(instance.definition);
+    m_instances.erase(p_key);
+    return false;
+}
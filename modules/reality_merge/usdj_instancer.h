@@ -0,0 +1,148 @@
+/**************************************************************************/
+/* usdj_instancer.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_INSTANCER_H
+#define REALITY_MERGE_USDJ_INSTANCER_H
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// third-party
+#include <cavi/usdj_am/definition.hpp>
+#include <cavi/usdj_am/usd/geom/token_type.hpp>
+
+// regional
+#include <core/math/color.h>
+#include <core/math/transform_3d.h>
+#include <core/object/object_id.h>
+#include <core/object/ref_counted.h>
+
+// local
+#include "usdj_prim_representation.h"
+
+class MultiMesh;
+class Node;
+
+/// \brief A renderer of the USD prims that need neither physics nor picking
+///        through one `MultiMeshInstance3D` per kind of geometry and class of
+///        material instead of a physics body per prim.
+class UsdjInstancer : public UsdjPrimRepresentation {
+public:
+    UsdjInstancer();
+
+    UsdjInstancer(UsdjInstancer const&) = delete;
+
+    UsdjInstancer(UsdjInstancer&&) = delete;
+
+    /// \brief Frees the nodes of the batches.
+    ~UsdjInstancer() override;
+
+    UsdjInstancer& operator=(UsdjInstancer const&) = delete;
+
+    UsdjInstancer& operator=(UsdjInstancer&&) = delete;
+
+    void begin_pass(Node* const p_parent, bool const p_stale) override;
+
+    /// \brief Removes all of the instances and frees the nodes of the batches.
+    void clear() override;
+
+    bool contains(std::string const& p_key) const override;
+
+    void end_pass() override;
+
+    /// \returns The count of batches.
+    std::size_t get_batch_count() const;
+
+    void invalidate(std::string const& p_key) override;
+
+    bool revise(std::string const& p_key) override;
+
+    std::size_t size() const override;
+
+    bool visit(std::string const& p_key, cavi::usdj_am::Definition& p_definition) override;
+
+private:
+    /// \brief A kind of geometry as a type of gprim and whether its material
+    ///        is transparent.
+    using BatchKey = std::pair<cavi::usdj_am::usd::geom::TokenType, bool>;
+
+    /// \brief The instances that share a `MultiMeshInstance3D`.
+    struct Batch {
+        Ref<MultiMesh> multi_mesh;
+        ObjectID node_id;
+        /// \brief The encoded object IDs of the USD prims in instance order.
+        std::vector<std::string> keys;
+        std::vector<Transform3D> transforms;
+        std::vector<Color> colors;
+    };
+
+    /// \brief A USD prim rendered as an instance.
+    struct Instance {
+        /// \brief The key of the batch containing the instance or
+        ///        `std::nullopt` if it hasn't been placed in one yet.
+        std::optional<BatchKey> batch_key;
+        /// \brief The instance's position within its batch.
+        std::size_t slot;
+        cavi::usdj_am::Definition definition;
+        bool stale;
+        bool visited;
+    };
+
+    static_assert(std::is_move_assignable_v<cavi::usdj_am::Definition>,
+                  "Reextracting an instance moves definitions into and out of it.");
+
+    /// \returns The batch for the given key, creating it if necessary.
+    Batch& get_batch(BatchKey const& p_batch_key);
+
+    /// \brief Extracts a USD prim's properties into its instance, moving the
+    ///        instance into another batch if necessary.
+    ///
+    /// \param[in] p_key A USD prim's encoded object ID.
+    /// \param[in,out] p_instance The USD prim's instance.
+    /// \returns `false` if the USD prim needs a physics body.
+    bool place(std::string const& p_key, Instance& p_instance);
+
+    /// \brief Removes an instance from its batch by moving the batch's last
+    ///        instance into its slot.
+    ///
+    /// \param[in] p_instance An instance.
+    void vacate(Instance const& p_instance);
+
+    std::map<BatchKey, Batch> m_batches;
+    std::unordered_map<std::string, Instance> m_instances;
+    ObjectID m_parent_id;
+};
+
+#endif  // REALITY_MERGE_USDJ_INSTANCER_H
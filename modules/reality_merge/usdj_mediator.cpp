@@ -27,11 +27,14 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
 /**************************************************************************/
 
+#include <algorithm>
 #include <filesystem>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 // third-party
@@ -39,49 +42,36 @@ extern "C" {
 
 #include <automerge-c/automerge.h>
 }
+#include <cavi/usdj_am/utils/operations.hpp>
 
 // regional
 #include <core/config/project_settings.h>
 #include <core/error/error_macros.h>
 #include <core/io/dir_access.h>
-#include <core/io/json.h>
 #include <core/io/resource_loader.h>
-#include <core/templates/vector.h>
-#include <core/variant/dictionary.h>
+#include <core/object/callable_method_pointer.h>
+#include <core/object/object.h>
+#include <core/os/memory.h>
+#include <core/os/os.h>
+#include <scene/3d/camera_3d.h>
+#include <scene/main/viewport.h>
 
 // local
+#include "automerge_sync_session.h"
+#include "automerge_sync_worker.h"
 #include "usdj_body_updater.h"
 #include "usdj_mediator.h"
+#include "usdj_prim_extractor.h"
+#include "usdj_resource_cache.h"
 #include "usdj_static_body_3d.h"
 #include "uuid.h"
 
 namespace {
 
-static int const BUFFER_SIZE = (1 << 23) - 1;
-
-static int MAX_QUEUED_MESSAGES() {
-    static std::optional<int> value{};
-
-    if (!value)
-        value.emplace(static_cast<int>(GLOBAL_GET("network/limits/debugger/max_queued_messages")));
-    return *value;
-}
-
-static String PING_TEXT() {
-    static std::optional<String> text{};
-
-    if (!text) {
-        Dictionary request{};
-        request["ping"] = "ping";
-        Ref<JSON> json;
-        json.instantiate();
-        text = json->stringify(request, "\t", false);
-    }
-    return *text;
-}
-
 static char const* const RESOURCE_TYPE_NAME = "AutomergeResource";
 
+static char const* const SYNC_STATE_EXTENSION = "amsync";
+
 static String RESOURCE_EXTENSION() {
     static std::optional<String> extension{};
 
@@ -117,24 +107,66 @@ String find_document(String const& basename) {
 }  // namespace
 
 UsdjMediator::UsdjMediator()
-    : m_document_scan{false}, m_init_result{nullptr, nullptr}, m_init_syncing{false}, m_server_sync{false} {}
-
-UsdjMediator::~UsdjMediator() {}
+    : m_applied_counts{},
+      m_body_instancing{false},
+      m_body_materialization_budget{0.0},
+      m_body_server_direct{false},
+      m_deferred_call_count{0},
+      m_document_scan{false},
+      m_materializing{false},
+      m_reconciled_heads{nullptr, AMresultFree},
+      m_server_heartbeat_interval{AutomergeSyncSession::HEARTBEAT_INTERVAL_MSECS / 1000.0},
+      m_server_receive_budget{4.0},
+      m_server_sync{false},
+      m_server_threaded{false},
+      m_update_count{0},
+      m_updates_deferred{false} {}
+
+UsdjMediator::~UsdjMediator() {
+    stop_sync();
+}
 
 void UsdjMediator::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("get_body_instancing"), &UsdjMediator::get_body_instancing);
+    ClassDB::bind_method(D_METHOD("get_body_materialization_budget"),
+                         &UsdjMediator::get_body_materialization_budget);
+    ClassDB::bind_method(D_METHOD("get_body_pool_high_water_mark"), &UsdjMediator::get_body_pool_high_water_mark);
+    ClassDB::bind_method(D_METHOD("get_body_server_direct"), &UsdjMediator::get_body_server_direct);
     ClassDB::bind_method(D_METHOD("get_document_path"), &UsdjMediator::get_document_path);
     ClassDB::bind_method(D_METHOD("get_document_resource"), &UsdjMediator::get_document_resource);
     ClassDB::bind_method(D_METHOD("get_document_scan"), &UsdjMediator::get_document_scan);
     ClassDB::bind_method(D_METHOD("get_server_domain_name"), &UsdjMediator::get_server_domain_name);
+    ClassDB::bind_method(D_METHOD("get_server_heartbeat_interval"), &UsdjMediator::get_server_heartbeat_interval);
     ClassDB::bind_method(D_METHOD("get_server_path"), &UsdjMediator::get_server_path);
+    ClassDB::bind_method(D_METHOD("get_server_receive_budget"), &UsdjMediator::get_server_receive_budget);
+    ClassDB::bind_method(D_METHOD("get_server_round_trip_time"), &UsdjMediator::get_server_round_trip_time);
     ClassDB::bind_method(D_METHOD("get_server_sync"), &UsdjMediator::get_server_sync);
+    ClassDB::bind_method(D_METHOD("get_server_threaded"), &UsdjMediator::get_server_threaded);
+    ClassDB::bind_method(D_METHOD("get_update_statistics"), &UsdjMediator::get_update_statistics);
+    ClassDB::bind_method(D_METHOD("set_body_instancing"), &UsdjMediator::set_body_instancing);
+    ClassDB::bind_method(D_METHOD("set_body_materialization_budget"),
+                         &UsdjMediator::set_body_materialization_budget);
+    ClassDB::bind_method(D_METHOD("set_body_pool_high_water_mark"), &UsdjMediator::set_body_pool_high_water_mark);
+    ClassDB::bind_method(D_METHOD("set_body_server_direct"), &UsdjMediator::set_body_server_direct);
     ClassDB::bind_method(D_METHOD("set_document_path"), &UsdjMediator::set_document_path);
     ClassDB::bind_method(D_METHOD("set_document_resource"), &UsdjMediator::set_document_resource);
     ClassDB::bind_method(D_METHOD("set_document_scan"), &UsdjMediator::set_document_scan);
     ClassDB::bind_method(D_METHOD("set_server_domain_name"), &UsdjMediator::set_server_domain_name);
+    ClassDB::bind_method(D_METHOD("set_server_heartbeat_interval"), &UsdjMediator::set_server_heartbeat_interval);
     ClassDB::bind_method(D_METHOD("set_server_path"), &UsdjMediator::set_server_path);
+    ClassDB::bind_method(D_METHOD("set_server_receive_budget"), &UsdjMediator::set_server_receive_budget);
     ClassDB::bind_method(D_METHOD("set_server_sync"), &UsdjMediator::set_server_sync);
-
+    ClassDB::bind_method(D_METHOD("set_server_threaded"), &UsdjMediator::set_server_threaded);
+
+    ADD_GROUP("Body", "body_");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "body_instancing"), "set_body_instancing", "get_body_instancing");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "body_materialization_budget", PROPERTY_HINT_RANGE,
+                              "0,100,0.1,or_greater,suffix:ms"),
+                 "set_body_materialization_budget", "get_body_materialization_budget");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "body_pool_high_water_mark", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"),
+                 "set_body_pool_high_water_mark", "get_body_pool_high_water_mark");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "body_server_direct"), "set_body_server_direct",
+                 "get_body_server_direct");
     ADD_GROUP("Document", "document_");
     ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "document_resource", PROPERTY_HINT_RESOURCE_TYPE, RESOURCE_TYPE_NAME),
                  "set_document_resource", "get_document_resource");
@@ -143,8 +175,20 @@ void UsdjMediator::_bind_methods() {
     ADD_GROUP("Server", "server_");
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "server_domain_name"), "set_server_domain_name",
                  "get_server_domain_name");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "server_heartbeat_interval", PROPERTY_HINT_RANGE,
+                              "0.1,60,0.1,or_greater,suffix:s"),
+                 "set_server_heartbeat_interval", "get_server_heartbeat_interval");
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "server_path"), "set_server_path", "get_server_path");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "server_receive_budget", PROPERTY_HINT_RANGE,
+                              "0,100,0.1,or_greater,suffix:ms"),
+                 "set_server_receive_budget", "get_server_receive_budget");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "server_round_trip_time", PROPERTY_HINT_NONE, "suffix:s",
+                              PROPERTY_USAGE_EDITOR | PROPERTY_USAGE_READ_ONLY),
+                 "", "get_server_round_trip_time");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "server_sync"), "set_server_sync", "get_server_sync");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "server_threaded"), "set_server_threaded", "get_server_threaded");
+
+    ADD_SIGNAL(MethodInfo("scene_materialized"));
 }
 
 void UsdjMediator::_notification(int p_what) {
@@ -154,8 +198,11 @@ void UsdjMediator::_notification(int p_what) {
                 update_bodies();
             } else {
                 // Keep the connection, if there is one, alive.
-                send_ping();
+                heartbeat();
             }
+            materialize();
+            if (m_body_server_direct)
+                m_server_prims.follow_parent();
             break;
         }
         case NOTIFICATION_READY: {
@@ -165,53 +212,115 @@ void UsdjMediator::_notification(int p_what) {
     }
 }
 
-Error UsdjMediator::ensure_connection() {
-    if (m_server_socket.is_null()) {
-        m_server_socket = Ref<WebSocketPeer>(WebSocketPeer::create());
-        ERR_FAIL_COND_V(m_server_socket.is_null(), ERR_CANT_CREATE);
-        Vector<String> protocols;
-        protocols.push_back("binary");
-        m_server_socket->set_supported_protocols(protocols);
-        m_server_socket->set_max_queued_packets(MAX_QUEUED_MESSAGES());
-        m_server_socket->set_inbound_buffer_size(BUFFER_SIZE);
-        m_server_socket->set_outbound_buffer_size(BUFFER_SIZE);
+void UsdjMediator::apply_updates() {
+    m_updates_deferred = false;
+    auto pending_bodies = PendingBodies{};
+    pending_bodies.swap(m_pending_bodies);
+    auto const get_body = [](ObjectID const& id) {
+        return Object::cast_to<UsdjStaticBody3D>(ObjectDB::get_instance(id));
+    };
+    auto const index = [](Action const action) {
+        return static_cast<std::size_t>(action) - static_cast<std::size_t>(Action::BEGIN__);
+    };
+    auto parent = get_parent();
+    if (!parent) {
+        // The added bodies have nowhere to go.
+        for (auto const& id : pending_bodies[index(Action::ADD)]) {
+            auto const body = get_body(id);
+            if (!body)
+                continue;
+            // Don't let the next reconciliation find a body that was pooled.
+            if (m_body_index && body->get_object_id()) {
+                auto const match = m_body_index->find(UsdjBodyUpdater::make_key(body->get_object_id()));
+                if (match != m_body_index->end() && match->second == id)
+                    m_body_index->erase(match);
+            }
+            m_body_pool.release(body);
+        }
+        return;
     }
-    auto ready_state = m_server_socket->get_ready_state();
-    if (ready_state == WebSocketPeer::STATE_OPEN) {
-        return OK;
+    // These are physics bodies that weren't described by the USDJ previously.
+    for (auto const& id : pending_bodies[index(Action::ADD)]) {
+        if (auto const body = get_body(id)) {
+            parent->add_child(body);
+            body->set_owner(parent);
+            ++m_applied_counts[index(Action::ADD)];
+            m_materializing = true;
+        }
+    }
+    // These are physics bodies that are still described by the USDJ.
+    auto& kept_ids = pending_bodies[index(Action::KEEP)];
+    std::sort(kept_ids.begin(), kept_ids.end());
+    kept_ids.erase(std::unique(kept_ids.begin(), kept_ids.end()), kept_ids.end());
+    for (auto const& id : kept_ids) {
+        if (auto const body = get_body(id)) {
+            body->revise();
+            ++m_applied_counts[index(Action::KEEP)];
+        }
     }
-    auto const url = String{"wss://"} + m_server_domain_name;
-    ERR_FAIL_COND_V(m_server_socket->connect_to_url(url, TLSOptions::client()) != OK, ERR_CANT_CONNECT);
-    m_server_socket->poll();
-    ready_state = m_server_socket->get_ready_state();
-    if (ready_state != WebSocketPeer::STATE_CONNECTING && ready_state != WebSocketPeer::STATE_OPEN) {
-        m_server_socket.unref();
-        ERR_FAIL_V_MSG(ERR_CANT_CONNECT,
-                       vformat("Unable to connect to server \"%s\": state is %s.", m_server_domain_name, ready_state));
+    // These are physics bodies that are no longer described by the USDJ.
+    for (auto const& id : pending_bodies[index(Action::REMOVE)]) {
+        auto const body = get_body(id);
+        if (body && body->get_parent() == parent) {
+            parent->remove_child(body);
+            m_body_pool.release(body);
+            ++m_applied_counts[index(Action::REMOVE)];
+        }
     }
-    // Wait for the WebSocket connection to open.
-    while (ready_state == WebSocketPeer::STATE_CONNECTING) {
-        m_server_socket->poll();
-        ready_state = m_server_socket->get_ready_state();
+    if (!(kept_ids.empty() && pending_bodies[index(Action::REMOVE)].empty())) {
+        // Release the shared resources that the revised and freed bodies
+        // no longer refer to.
+        UsdjResourceCache::get_singleton()->trim();
     }
-    if (ready_state == WebSocketPeer::STATE_OPEN) {
-        // Disable Nagle's algorithm.
-        m_server_socket->set_no_delay(true);
-        // Request updates of the Automerge document.
-        Dictionary request{};
-        request["wa"] = "open";
-        Dictionary body{};
-        body["strateId"] = m_server_path;
-        if (m_server_peer_id.is_empty())
-            m_server_peer_id = generate_uuidv4();
-        body["peerId"] = m_server_peer_id;
-        request["body"] = body;
-        Ref<JSON> json;
-        json.instantiate();
-        ERR_FAIL_COND_V(m_server_socket->send_text(json->stringify(request, "\t", false)) != OK, ERR_QUERY_FAILED);
-        m_init_syncing = true;
+    if (m_materializing && m_materializations.empty()) {
+        m_materializing = false;
+        emit_signal(SNAME("scene_materialized"));
     }
-    return OK;
+}
+
+std::unique_ptr<AutomergeSyncSession> UsdjMediator::create_session(AMdoc* const p_document) {
+    if (m_server_peer_id.is_empty())
+        m_server_peer_id = generate_uuidv4();
+    auto session = std::make_unique<AutomergeSyncSession>(m_server_domain_name, m_server_path, m_server_peer_id);
+    session->set_heartbeat_interval(static_cast<std::uint64_t>(m_server_heartbeat_interval * 1000.0));
+    // Resume where the previous session with this server left off.
+    auto const path = get_sync_state_path();
+    if (!path.is_empty())
+        session->restore_sync_state(p_document, path);
+    return session;
+}
+
+void UsdjMediator::defer_updates(UsdjBodyUpdater::Updates const& p_updates) {
+    ++m_update_count;
+    for (auto pos = static_cast<std::size_t>(Action::BEGIN__); pos != static_cast<std::size_t>(Action::END__); ++pos) {
+        auto const action = static_cast<Action>(pos);
+        auto& pending_ids = m_pending_bodies[pos - static_cast<std::size_t>(Action::BEGIN__)];
+        for (auto const body : p_updates[action]) {
+            pending_ids.push_back(body->get_instance_id());
+        }
+    }
+    if (!m_updates_deferred && !p_updates.empty()) {
+        // Apply every update made before the end of the frame at once.
+        callable_mp(this, &UsdjMediator::apply_updates).call_deferred();
+        m_updates_deferred = true;
+        ++m_deferred_call_count;
+    }
+}
+
+bool UsdjMediator::get_body_instancing() const {
+    return m_body_instancing;
+}
+
+double UsdjMediator::get_body_materialization_budget() const {
+    return m_body_materialization_budget;
+}
+
+int64_t UsdjMediator::get_body_pool_high_water_mark() const {
+    return static_cast<int64_t>(m_body_pool.get_high_water_mark());
+}
+
+bool UsdjMediator::get_body_server_direct() const {
+    return m_body_server_direct;
 }
 
 PackedStringArray UsdjMediator::get_configuration_warnings() const {
@@ -250,30 +359,167 @@ String UsdjMediator::get_server_domain_name() const {
     return m_server_domain_name;
 }
 
+double UsdjMediator::get_server_heartbeat_interval() const {
+    return m_server_heartbeat_interval;
+}
+
 String UsdjMediator::get_server_path() const {
     return m_server_path;
 }
 
+double UsdjMediator::get_server_receive_budget() const {
+    return m_server_receive_budget;
+}
+
+double UsdjMediator::get_server_round_trip_time() const {
+    std::int64_t msecs = -1;
+    if (m_server_worker)
+        msecs = m_server_worker->get_round_trip_msecs();
+    else if (m_server_channel)
+        msecs = m_server_channel->session->get_round_trip_msecs();
+    return (msecs < 0) ? -1.0 : msecs / 1000.0;
+}
+
 bool UsdjMediator::get_server_sync() const {
     return m_server_sync;
 }
 
-Error UsdjMediator::send_ping() {
-    if (!m_server_sync)
+bool UsdjMediator::get_server_threaded() const {
+    return m_server_threaded;
+}
+
+Dictionary UsdjMediator::get_update_statistics() const {
+    auto const index = [](Action const action) {
+        return static_cast<std::size_t>(action) - static_cast<std::size_t>(Action::BEGIN__);
+    };
+    Dictionary statistics;
+    statistics["updates"] = m_update_count;
+    statistics["deferred_calls"] = m_deferred_call_count;
+    statistics["bodies_added"] = m_applied_counts[index(Action::ADD)];
+    statistics["bodies_revised"] = m_applied_counts[index(Action::KEEP)];
+    statistics["bodies_removed"] = m_applied_counts[index(Action::REMOVE)];
+    statistics["pool_hits"] = m_body_pool.get_hit_count();
+    statistics["pool_misses"] = m_body_pool.get_miss_count();
+    statistics["pool_size"] = static_cast<uint64_t>(m_body_pool.size());
+    statistics["instances"] = static_cast<uint64_t>(m_instancer.size());
+    statistics["instance_batches"] = static_cast<uint64_t>(m_instancer.get_batch_count());
+    statistics["server_prims"] = static_cast<uint64_t>(m_server_prims.size());
+    return statistics;
+}
+
+Vector3 UsdjMediator::get_eye() const {
+    auto const viewport = get_viewport();
+    auto const camera_3d = (viewport) ? viewport->get_camera_3d() : nullptr;
+    auto const eye = (camera_3d) ? camera_3d->get_global_position() : get_global_position();
+    auto const parent_3d = Object::cast_to<Node3D>(get_parent());
+    return (parent_3d) ? parent_3d->to_local(eye) : eye;
+}
+
+UsdjPrimRepresentation* UsdjMediator::get_prim_representation() {
+    // Representing the prims within the servers supersedes instancing them.
+    if (m_body_server_direct)
+        return &m_server_prims;
+    if (m_body_instancing)
+        return &m_instancer;
+    return nullptr;
+}
+
+String UsdjMediator::get_sync_state_path() const {
+    if (m_document_resource.is_null())
+        return String{};
+    auto const document_path = m_document_resource->get_path();
+    if (!document_path.is_resource_file())
+        return String{};
+    // Key the file by both the server and the document's ID on it.
+    auto const key = (m_server_domain_name + "_" + m_server_path).validate_filename();
+    return document_path.get_basename() + "." + key + "." + SYNC_STATE_EXTENSION;
+}
+
+Error UsdjMediator::heartbeat() {
+    // A worker thread keeps its own connection alive.
+    if (!m_server_channel)
         return OK;
-    ensure_connection();
-    m_server_socket->poll();
-    auto ready_state = m_server_socket->get_ready_state();
-    // Wait for the WebSocket connection to open.
-    while (ready_state == WebSocketPeer::STATE_CONNECTING) {
-        m_server_socket->poll();
-        ready_state = m_server_socket->get_ready_state();
+    return m_server_channel->session->heartbeat();
+}
+
+void UsdjMediator::materialize() {
+    if (m_materializations.empty() || !m_body_index)
+        return;
+    auto const eye = get_eye();
+    auto const is_farther = [eye](Materialization const& lhs, Materialization const& rhs) {
+        return lhs.origin.distance_squared_to(eye) > rhs.origin.distance_squared_to(eye);
+    };
+    if (eye != m_materialization_eye) {
+        // Reprioritize the prims for the eye's new position.
+        std::make_heap(m_materializations.begin(), m_materializations.end(), is_farther);
+        m_materialization_eye = eye;
     }
-    if (ready_state == WebSocketPeer::STATE_OPEN) {
-        // Send a ping message.
-        ERR_FAIL_COND_V(m_server_socket->send_text(PING_TEXT()) != OK, FAILED);
+    auto const budget_usecs = static_cast<uint64_t>(m_body_materialization_budget * 1000.0);
+    auto const start_usecs = OS::get_singleton()->get_ticks_usec();
+    UsdjBodyUpdater::Updates updates;
+    do {
+        std::pop_heap(m_materializations.begin(), m_materializations.end(), is_farther);
+        auto materialization = std::move(m_materializations.back());
+        m_materializations.pop_back();
+        try {
+            auto const body = m_body_pool.acquire(std::move(materialization.deferral.definition));
+            (*m_body_index)[materialization.deferral.key] = body->get_instance_id();
+            updates[Action::ADD].push_back(body);
+        } catch (std::invalid_argument const&) {
+            // The next reconciliation will defer this prim again.
+        }
+    } while (!m_materializations.empty() && OS::get_singleton()->get_ticks_usec() - start_usecs < budget_usecs);
+    defer_updates(updates);
+}
+
+void UsdjMediator::queue_materializations(UsdjBodyUpdater::Deferrals&& p_deferrals) {
+    // The prims that are still awaiting bodies have been deferred again.
+    m_materializations.clear();
+    m_materializations.reserve(p_deferrals.size());
+    for (auto& deferral : p_deferrals) {
+        auto const origin = UsdjPrimExtractor{deferral.definition}().transform.value_or(Transform3D{}).origin;
+        m_materializations.push_back(Materialization{std::move(deferral), origin});
+    }
+    p_deferrals.clear();
+    m_materialization_eye.reset();
+}
+
+void UsdjMediator::set_body_instancing(bool const p_instancing) {
+    if (p_instancing != m_body_instancing) {
+        m_body_instancing = p_instancing;
+        if (get_prim_representation() != &m_instancer)
+            m_instancer.clear();
+        // The next update must decide anew which prims are instanced.
+        m_reconciled_heads.reset();
+        m_reconciled_root.reset();
+        if (m_document_scan)
+            update_bodies();
+    }
+}
+
+void UsdjMediator::set_body_materialization_budget(double const p_budget) {
+    ERR_FAIL_COND_MSG(p_budget < 0.0, "The materialization budget can't be negative.");
+    m_body_materialization_budget = p_budget;
+}
+
+void UsdjMediator::set_body_pool_high_water_mark(int64_t const p_high_water_mark) {
+    ERR_FAIL_COND_MSG(p_high_water_mark < 0, "The high-water mark can't be negative.");
+    m_body_pool.set_high_water_mark(static_cast<std::size_t>(p_high_water_mark));
+}
+
+void UsdjMediator::set_body_server_direct(bool const p_server_direct) {
+    if (p_server_direct != m_body_server_direct) {
+        m_body_server_direct = p_server_direct;
+        if (get_prim_representation() != &m_instancer)
+            m_instancer.clear();
+        if (!m_body_server_direct)
+            m_server_prims.clear();
+        // The next update must decide anew which prims are represented.
+        m_reconciled_heads.reset();
+        m_reconciled_root.reset();
+        if (m_document_scan)
+            update_bodies();
     }
-    return OK;
 }
 
 void UsdjMediator::set_document_path(String const& p_path) {
@@ -291,11 +537,11 @@ void UsdjMediator::set_document_resource(Ref<AutomergeResource> const& p_resourc
     if (p_resource != m_document_resource) {
         m_document_resource = p_resource;
         if (!m_document_resource.is_null()) {
-            // Reset the Automerge document's associated synchronization state.
-            m_init_result = ResultPtr{AMsyncStateInit(), AMresultFree};
+            // The synchronization state of the previous document and the
+            // worker thread's copy of it are obsolete.
+            stop_sync();
         } else {
             // There is no document to synchronize at this point.
-            m_init_result.reset();
             set_server_sync(false);
         }
         /// \note The user must reactivate document scanning to indicate when
@@ -307,6 +553,12 @@ void UsdjMediator::set_document_resource(Ref<AutomergeResource> const& p_resourc
 void UsdjMediator::set_document_scan(bool const p_scan) {
     if (p_scan != m_document_scan) {
         m_document_scan = p_scan && !(m_document_resource.is_null() || m_document_path.is_empty());
+        // The next update must reconcile all of the bodies.
+        m_body_index.reset();
+        m_materializations.clear();
+        m_reconciled_heads.reset();
+        m_reconciled_root.reset();
+        m_scene_index.reset();
         if (m_document_scan)
             update_bodies();
     }
@@ -321,6 +573,16 @@ void UsdjMediator::set_server_domain_name(String const& p_domain_name) {
     }
 }
 
+void UsdjMediator::set_server_heartbeat_interval(double const p_interval) {
+    ERR_FAIL_COND_MSG(p_interval <= 0.0, "The heartbeat interval must be positive.");
+    m_server_heartbeat_interval = p_interval;
+    auto const msecs = static_cast<std::uint64_t>(m_server_heartbeat_interval * 1000.0);
+    if (m_server_channel)
+        m_server_channel->session->set_heartbeat_interval(msecs);
+    if (m_server_worker)
+        m_server_worker->set_heartbeat_interval(msecs);
+}
+
 void UsdjMediator::set_server_path(String const& p_path) {
     if (p_path != m_server_path) {
         m_server_path = p_path;
@@ -330,15 +592,19 @@ void UsdjMediator::set_server_path(String const& p_path) {
     }
 }
 
+void UsdjMediator::set_server_receive_budget(double const p_budget) {
+    ERR_FAIL_COND_MSG(p_budget < 0.0, "The receive budget can't be negative.");
+    m_server_receive_budget = p_budget;
+}
+
 void UsdjMediator::set_server_sync(bool const p_sync) {
     namespace fs = std::filesystem;
     using cavi::usdj_am::utils::Document;
 
     if (p_sync != m_server_sync) {
         m_server_sync = p_sync && !(m_server_domain_name.is_empty() || m_server_path.is_empty());
-        if (!m_server_sync && !m_server_socket.is_null()) {
-            m_server_socket->close();
-            m_server_socket.unref();
+        if (!m_server_sync) {
+            stop_sync();
         } else if (m_server_sync && m_document_resource.is_null()) {
             // Search for an Automerge document named after the server path.
             auto path = find_document(m_server_path);
@@ -362,72 +628,115 @@ void UsdjMediator::set_server_sync(bool const p_sync) {
     }
 }
 
-bool UsdjMediator::receive_changes() {
-    static Ref<JSON> json_parser;
+void UsdjMediator::set_server_threaded(bool const p_threaded) {
+    if (p_threaded != m_server_threaded) {
+        m_server_threaded = p_threaded;
+        // Synchronization will resume on the appropriate thread.
+        stop_sync();
+    }
+}
 
-    if (!m_server_sync || ensure_connection() != OK)
+bool UsdjMediator::revise_bodies(cavi::usdj_am::SceneChanges const& p_changes) {
+    using cavi::usdj_am::SceneChangeType;
+
+    if (!m_body_index)
         return false;
-    bool result = false;
-    m_server_socket->poll();
-    auto const ready_state = m_server_socket->get_ready_state();
-    switch (ready_state) {
-        case WebSocketPeer::STATE_OPEN: {
-            auto document = m_document_resource->get_document();
-            AMsyncState* client_state = nullptr;
-            ERR_FAIL_COND_V(!AMitemToSyncState(AMresultItem(m_init_result.get()), &client_state), false);
-            auto packet_count = m_server_socket->get_available_packet_count();
-            while (packet_count && m_server_socket->get_ready_state() == WebSocketPeer::STATE_OPEN) {
-                std::uint8_t const* r_buffer = nullptr;
-                int r_buffer_size = 0;
-                auto const error = m_server_socket->get_packet(&r_buffer, r_buffer_size);
-                ERR_FAIL_COND_V(error != OK, false);
-                ERR_FAIL_COND_V(r_buffer_size <= 0, false);
-                // Ignore a JSON message.
-                String const json_string{reinterpret_cast<char const*>(r_buffer), static_cast<int>(r_buffer_size)};
-                if (json_parser.is_null())
-                    json_parser.instantiate();
-                if (json_parser->parse(json_string) != OK) {
-                    // Ignore the prepended message type signifier byte.
-                    ResultPtr const decode_result{AMsyncMessageDecode(r_buffer + 1, r_buffer_size - 1), AMresultFree};
-                    AMsyncMessage const* server_message = nullptr;
-                    if (AMitemToSyncMessage(AMresultItem(decode_result.get()), &server_message)) {
-                        ResultPtr const receive_result{
-                            AMreceiveSyncMessage(document->get(), client_state, server_message), AMresultFree};
-                        ERR_FAIL_COND_V(AMresultStatus(receive_result.get()) != AM_STATUS_OK, ERR_BUG);
-                        result = true;
-                    }
+    UsdjBodyUpdater::Updates updates;
+    auto& bodies = updates[Action::KEEP];
+    bodies.reserve(p_changes.size());
+    auto const representation = get_prim_representation();
+    for (auto const& change : p_changes) {
+        switch (change.type) {
+            case SceneChangeType::DECLARATION_CHANGED:
+            case SceneChangeType::DESCRIPTOR_CHANGED:
+            case SceneChangeType::XFORM_OP_ORDER_CHANGED: {
+                // A change to a prim without a body may have to do with which
+                // prims have bodies, e.g. the "defaultPrim" assignment.
+                auto const body = UsdjBodyUpdater::find(*m_body_index, change.object_id);
+                if (body) {
+                    bodies.push_back(body);
+                } else if (!(representation && representation->revise(UsdjBodyUpdater::make_key(change.object_id)))) {
+                    return false;
                 }
-                --packet_count;
+                break;
             }
-            if (result || m_init_syncing) {
-                ResultPtr const generate_result{AMgenerateSyncMessage(document->get(), client_state), AMresultFree};
-                AMsyncMessage const* client_message = nullptr;
-                if (AMitemToSyncMessage(AMresultItem(generate_result.get()), &client_message)) {
-                    ResultPtr const encode_result{AMsyncMessageEncode(client_message), AMresultFree};
-                    AMbyteSpan client_message_bytes = {0};
-                    ERR_FAIL_COND_V(!AMitemToBytes(AMresultItem(encode_result.get()), &client_message_bytes), false);
-                    // Prepend a message type signifier byte.
-                    std::vector<std::uint8_t> client_buffer{0};
-                    client_buffer.reserve(client_buffer.size() + client_message_bytes.count);
-                    client_buffer.insert(client_buffer.end(), client_message_bytes.src,
-                                         client_message_bytes.src + client_message_bytes.count);
-                    ERR_FAIL_COND_V(m_server_socket->put_packet(client_buffer.data(), client_buffer.size()) != OK,
-                                    false);
-                    m_init_syncing = false;
-                }
+            default: {
+                return false;
             }
-            break;
         }
-        case WebSocketPeer::STATE_CLOSING:
-            // Keep polling until it's closed.
-            break;
-        case WebSocketPeer::STATE_CLOSED: {
-            auto const code = m_server_socket->get_close_code();
-            auto const reason = m_server_socket->get_close_reason();
-            WARN_PRINT(vformat("WebSocket closed with code %d and reason \"%s\".", code, reason));
-            m_server_socket.unref();
-            break;
+    }
+    defer_updates(updates);
+    return true;
+}
+
+void UsdjMediator::skip_unchanged_bodies(UsdjBodyUpdater::Updates& p_updates,
+                                         cavi::usdj_am::SceneChanges const& p_changes) const {
+    std::unordered_set<UsdjBodyUpdater::Body*> changed_bodies;
+    for (auto const& change : p_changes) {
+        if (auto const body = UsdjBodyUpdater::find(*m_body_index, change.object_id))
+            changed_bodies.insert(body);
+    }
+    auto& kept_bodies = p_updates[Action::KEEP];
+    kept_bodies.erase(std::remove_if(kept_bodies.begin(), kept_bodies.end(),
+                                     [&](auto const body) { return !changed_bodies.count(body); }),
+                      kept_bodies.end());
+}
+
+Error UsdjMediator::start_worker() {
+    using cavi::usdj_am::utils::Document;
+
+    auto document = m_document_resource->get_document();
+    ERR_FAIL_COND_V(!document, ERR_UNCONFIGURED);
+    // Give the worker thread its own copy of the document without saving it
+    // because that would reset the baseline of its next incremental save.
+    try {
+        auto copy = Document{ResultPtr{AMfork(document->get(), nullptr), AMresultFree}};
+        auto session = create_session(copy);
+        m_server_worker = std::make_unique<AutomergeSyncWorker>(std::move(session), std::move(copy));
+    } catch (std::invalid_argument const& thrown) {
+        ERR_FAIL_V_MSG(ERR_CANT_CREATE, thrown.what());
+    }
+    return OK;
+}
+
+void UsdjMediator::stop_sync() {
+    m_server_worker.reset();
+    m_server_channel.reset();
+}
+
+bool UsdjMediator::receive_changes() {
+    if (!m_server_sync || m_document_resource.is_null())
+        return false;
+    auto document = m_document_resource->get_document();
+    if (!document)
+        return false;
+    std::optional<std::uint64_t> budget_usecs{};
+    if (m_server_receive_budget > 0.0)
+        budget_usecs = static_cast<std::uint64_t>(m_server_receive_budget * 1000.0);
+    if (!m_server_threaded) {
+        if (!m_server_channel) {
+            // Share the connection with any other mediator of this document.
+            auto const create = [&]() { return create_session(document->get()); };
+            m_server_channel = AutomergeSyncHub::get_singleton()->acquire(document->get(), m_server_domain_name,
+                                                                          m_server_path, create);
+            if (!m_server_channel)
+                return false;
         }
+        return m_server_channel->receive_changes(budget_usecs);
+    }
+    if (!m_server_worker && start_worker() != OK)
+        return false;
+    // Apply the changes that the worker thread has already synchronized.
+    auto const start_usecs = OS::get_singleton()->get_ticks_usec();
+    bool result = false;
+    while (auto advance = m_server_worker->pop_advance()) {
+        ResultPtr const load_result{
+            AMloadIncremental(document->get(), advance->changes.data(), advance->changes.size()), AMresultFree};
+        ERR_CONTINUE(AMresultStatus(load_result.get()) != AM_STATUS_OK);
+        result = true;
+        // Leave the rest for subsequent frames.
+        if (budget_usecs && OS::get_singleton()->get_ticks_usec() - start_usecs >= *budget_usecs)
+            break;
     }
     return result;
 }
@@ -436,43 +745,103 @@ void UsdjMediator::update_bodies() {
     auto parent = get_parent();
     if (!parent)
         return;
-    auto physics_bodies = parent->find_children("*", "PhysicsBody3D", false, false);
     if (!m_document_scan) {
         // Remove all bodies constructed by a previous update.
+        auto physics_bodies = parent->find_children("*", "PhysicsBody3D", false, false);
+        UsdjBodyUpdater::Updates updates;
         for (int pos = 0; pos != physics_bodies.size(); ++pos) {
             if (UsdjStaticBody3D* body = Object::cast_to<UsdjStaticBody3D>(physics_bodies[pos]))
-                parent->call_deferred(SNAME("remove_child"), body);
+                updates[Action::REMOVE].push_back(body);
         }
+        defer_updates(updates);
+        m_body_index.reset();
+        m_instancer.clear();
+        m_server_prims.clear();
+        m_materializations.clear();
+        m_reconciled_heads.reset();
+        m_reconciled_root.reset();
+        m_scene_index.reset();
         return;
     }
     auto document = m_document_resource->get_document();
     if (document) {
-        auto updater = UsdjBodyUpdater{physics_bodies};
         auto const buffer = m_document_path.to_utf8_buffer();
         auto const path = std::string{reinterpret_cast<std::string::const_pointer>(buffer.ptr()),
                                       static_cast<std::string::size_type>(buffer.size())};
-        auto updates = updater(document->get(), path);
-        for (auto const& item : updates) {
-            switch (item.first) {
-                case UsdjBodyUpdater::Action::ADD: {
-                    // It's a physics body that wasn't described by the USDJ
-                    // previously.
-                    parent->call_deferred(SNAME("add_child"), item.second);
-                    item.second->call_deferred(SNAME("set_owner"), parent);
-                    break;
-                }
-                case UsdjBodyUpdater::Action::KEEP: {
-                    // It's a physics body that's still described by the USDJ.
-                    item.second->call_deferred(SNAME("revise"));
-                    break;
+        ResultPtr heads{AMgetHeads(document->get()), AMresultFree};
+        std::optional<cavi::usdj_am::utils::Item> root;
+        try {
+            root.emplace(document->get().get_item(path));
+        } catch (std::exception const&) {
+            // Let the updater report the invalid path.
+        }
+        std::optional<cavi::usdj_am::SceneChanges> changes;
+        if (m_reconciled_heads && m_reconciled_root && m_scene_index && root) {
+            AMobjId const* const root_obj_id = AMitemObjId(*root);
+            // Reconciliation is unnecessary when the object at the document
+            // path is the same as before and its prims were only revised.
+            if (AMobjIdEqual(root_obj_id, AMitemObjId(*m_reconciled_root))) {
+                AMitems const before_heads = AMresultItems(m_reconciled_heads.get());
+                AMitems const after_heads = AMresultItems(heads.get());
+                try {
+                    // Only the operations since then are decoded, which is
+                    // cheaper than comparing the versions of the tree.
+                    auto const operations =
+                        cavi::usdj_am::utils::Operations{document->get(), &before_heads, &after_heads};
+                    if (!m_scene_index->is_changed(operations)) {
+                        m_reconciled_heads = std::move(heads);
+                        return;
+                    }
+                    // This also indexes the objects that were made since then.
+                    changes.emplace(*m_scene_index, operations, &after_heads);
+                    if (revise_bodies(*changes)) {
+                        m_reconciled_heads = std::move(heads);
+                        return;
+                    }
+                } catch (std::exception const&) {
+                    // The previous version is unknown so reconcile anyway.
+                    changes.reset();
                 }
-                case UsdjBodyUpdater::Action::REMOVE: {
-                    // It's a physics body that's no longer described by the
-                    // USDJ.
-                    parent->call_deferred(SNAME("remove_child"), item.second);
-                    break;
+            }
+        }
+        m_reconciled_heads = std::move(heads);
+        m_reconciled_root.reset();
+        if (root)
+            m_reconciled_root.emplace(*root);
+        if (!m_body_index) {
+            // Index the bodies constructed before the mediator was.
+            m_body_index.emplace(
+                UsdjBodyUpdater::make_index(parent->find_children("*", "PhysicsBody3D", false, false)));
+        }
+        auto const representation = get_prim_representation();
+        if (representation) {
+            // Only the represented prims that were changed must be extracted
+            // again unless the changes are unknown.
+            representation->begin_pass(parent, !changes);
+            if (changes) {
+                for (auto const& change : *changes) {
+                    representation->invalidate(UsdjBodyUpdater::make_key(change.object_id));
                 }
             }
         }
+        auto updater =
+            UsdjBodyUpdater{*m_body_index, m_body_pool, m_body_materialization_budget > 0.0, representation};
+        auto updates = updater(document->get(), path);
+        if (representation)
+            representation->end_pass();
+        if (changes)
+            skip_unchanged_bodies(updates, *changes);
+        queue_materializations(std::move(updates.get_deferrals()));
+        defer_updates(updates);
+        // The changes refer to objects within the previous index.
+        changes.reset();
+        m_scene_index.reset();
+        if (root) {
+            try {
+                m_scene_index.emplace(document->get(), *root);
+            } catch (std::exception const&) {
+                // The updater has already reported the invalid USDA_File node.
+            }
+        }
     }
 }
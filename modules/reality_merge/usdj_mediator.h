@@ -30,35 +30,65 @@
 #ifndef REALITY_MERGE_USDJ_MEDIATOR_H
 #define REALITY_MERGE_USDJ_MEDIATOR_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
 
 // third-party
+#include <cavi/usdj_am/scene_changes.hpp>
+#include <cavi/usdj_am/scene_index.hpp>
 #include <cavi/usdj_am/utils/document.hpp>
+#include <cavi/usdj_am/utils/item.hpp>
 
 // regional
 #include <core/error/error_list.h>
+#include <core/object/object_id.h>
 #include <core/object/ref_counted.h>
 #include <core/string/ustring.h>
+#include <core/variant/dictionary.h>
 #include <core/variant/variant.h>
-#include <modules/websocket/websocket_peer.h>
 #include <scene/3d/node_3d.h>
 
 // local
 #include "automerge_resource.h"
+#include "automerge_sync_hub.h"
+#include "usdj_body_pool.h"
+#include "usdj_body_updater.h"
+#include "usdj_instancer.h"
+#include "usdj_prim_representation.h"
+#include "usdj_server_prims.h"
 
-struct AMresult;
+struct AMdoc;
+class AutomergeSyncWorker;
 
 class UsdjMediator : public Node3D {
     GDCLASS(UsdjMediator, Node3D);
 
 public:
-    static std::uint64_t const HANDSHAKE_TIMEOUT_MSECS = 6000;
-
     UsdjMediator();
 
     ~UsdjMediator();
 
+    /// \returns The toggle for rendering the prims that need neither physics
+    ///          nor picking as instances instead of bodies.
+    bool get_body_instancing() const;
+
+    /// \returns The time in milliseconds per frame for constructing new bodies
+    ///          or `0.0` for constructing them all at once.
+    double get_body_materialization_budget() const;
+
+    /// \returns The count of removed bodies above which they're freed instead
+    ///          of being pooled for reuse.
+    int64_t get_body_pool_high_water_mark() const;
+
+    /// \returns The toggle for representing the prims directly within the
+    ///          rendering and physics servers instead of as nodes.
+    bool get_body_server_direct() const;
+
     PackedStringArray get_configuration_warnings() const override;
 
     /// \returns The POSIX path to a map object within the Automerge document.
@@ -73,12 +103,56 @@ public:
     /// \returns The server's URL domain name component.
     String get_server_domain_name() const;
 
+    /// \returns The period of silence in seconds after which a keepalive
+    ///          message is sent to the server.
+    double get_server_heartbeat_interval() const;
+
     /// \returns The server's URL path component.
     String get_server_path() const;
 
+    /// \returns The time in milliseconds per frame for applying the changes
+    ///          received from the server or `0.0` for no limit.
+    double get_server_receive_budget() const;
+
+    /// \returns The smoothed round-trip time in seconds of the keepalive
+    ///          messages sent to the server or `-1.0` if none of them has been
+    ///          answered yet.
+    double get_server_round_trip_time() const;
+
     /// \returns The server synchronization toggle.
     bool get_server_sync() const;
 
+    /// \returns The toggle for synchronizing with the server on a worker
+    ///          thread.
+    bool get_server_threaded() const;
+
+    /// \returns A dictionary of the counts of updates to the bodies, the
+    ///          deferred calls made to apply them, the bodies added, revised
+    ///          and removed by them, the bodies taken from and kept within
+    ///          the pool, the instanced prims and their batches and the
+    ///          prims represented directly within the servers.
+    Dictionary get_update_statistics() const;
+
+    /// \param[in] p_instancing A toggle for rendering the prims that need
+    ///                         neither physics nor picking as instances
+    ///                         instead of bodies.
+    void set_body_instancing(bool const p_instancing);
+
+    /// \param[in] p_budget A time in milliseconds per frame for constructing
+    ///                     new bodies, nearest to the active camera first, or
+    ///                     `0.0` for constructing them all at once.
+    void set_body_materialization_budget(double const p_budget);
+
+    /// \param[in] p_high_water_mark A count of removed bodies above which
+    ///                              they're freed instead of being pooled for
+    ///                              reuse.
+    void set_body_pool_high_water_mark(int64_t const p_high_water_mark);
+
+    /// \param[in] p_server_direct A toggle for representing the prims
+    ///                            directly within the rendering and physics
+    ///                            servers instead of as nodes.
+    void set_body_server_direct(bool const p_server_direct);
+
     /// \param[in] p_path A POSIX path to a map object within an Automerge
     ///                   document.
     void set_document_path(String const& p_path);
@@ -92,41 +166,166 @@ public:
     /// \param[in] p_domain_name A server's URL domain name component.
     void set_server_domain_name(String const& p_domain_name);
 
+    /// \param[in] p_interval A period of silence in seconds after which a
+    ///                       keepalive message is sent to the server.
+    void set_server_heartbeat_interval(double const p_interval);
+
     /// \param[in] p_path A server's URL path component.
     void set_server_path(String const& p_path);
 
+    /// \param[in] p_budget A time in milliseconds per frame for applying the
+    ///                     changes received from the server or `0.0` for no
+    ///                     limit.
+    void set_server_receive_budget(double const p_budget);
+
     /// \param[in] p_sync A server synchronization toggle.
     void set_server_sync(bool const p_sync);
 
+    /// \param[in] p_threaded A toggle for synchronizing with the server on a
+    ///                       worker thread.
+    void set_server_threaded(bool const p_threaded);
+
 protected:
     static void _bind_methods();
 
     void _notification(int p_what);
 
-    /// \brief Ensures that there's a connection to the server.
-    ///
-    /// \returns `Error::OK` if a connection exists.
-    Error ensure_connection();
+    /// \brief Keeps the connection to the server, if any, alive.
+    Error heartbeat();
 
+    /// \brief Applies the changes received from the server to the Automerge
+    ///        document.
+    ///
+    /// \returns `true` if the Automerge document was changed.
     bool receive_changes();
 
-    Error send_ping();
-
     void update_bodies();
 
 private:
+    using Action = UsdjBodyUpdater::Action;
     using ResultPtr = cavi::usdj_am::utils::Document::ResultPtr;
 
+    /// \brief A USD prim awaiting the construction of its body.
+    struct Materialization {
+        UsdjBodyUpdater::Deferral deferral;
+        /// \brief The prim's position relative to the bodies' parent.
+        Vector3 origin;
+    };
+
+    static_assert(std::is_move_assignable_v<Materialization>, "The materialization heap moves its elements.");
+
+    /// \brief The IDs of the bodies awaiting each kind of action.
+    using PendingBodies = std::array<std::vector<ObjectID>, static_cast<std::size_t>(Action::SIZE__)>;
+
+    /// \brief Applies all of the pending updates to the bodies in one pass.
+    void apply_updates();
+
+    /// \brief Creates a session for synchronizing the given Automerge document
+    ///        with the server.
+    ///
+    /// \param[in] p_document A pointer to a borrowed Automerge document.
+    std::unique_ptr<AutomergeSyncSession> create_session(AMdoc* const p_document);
+
+    /// \brief Queues updates to the bodies for a single deferred application.
+    ///
+    /// \param[in] p_updates Bodies sorted into categories of actions.
+    void defer_updates(UsdjBodyUpdater::Updates const& p_updates);
+
+    /// \returns The position of the active camera, or this node in lieu of
+    ///          one, relative to the bodies' parent.
+    Vector3 get_eye() const;
+
+    /// \returns The representation of the prims that don't need bodies or
+    ///          `nullptr` if every prim needs one.
+    UsdjPrimRepresentation* get_prim_representation();
+
+    /// \brief Constructs the bodies of the nearest USD prims awaiting
+    ///        construction until the materialization budget is spent.
+    void materialize();
+
+    /// \brief Replaces the USD prims awaiting the construction of bodies.
+    ///
+    /// \param[in] p_deferrals The USD prims whose bodies have yet to be
+    ///                        constructed.
+    void queue_materializations(UsdjBodyUpdater::Deferrals&& p_deferrals);
+
+    /// \returns The path to the file of the synchronization state shared by
+    ///          the Automerge document and the server or an empty string if
+    ///          the document resource has no file.
+    String get_sync_state_path() const;
+
+    /// \brief Revises only the bodies affected by the given changes.
+    ///
+    /// \param[in] p_changes The changes to the USDJ since the last update.
+    /// \returns `false` if the changes require the bodies to be reconciled.
+    bool revise_bodies(cavi::usdj_am::SceneChanges const& p_changes);
+
+    /// \brief Removes the bodies whose USD prims weren't changed from those
+    ///        that are kept so that they won't be revised.
+    ///
+    /// \param[in,out] p_updates Bodies sorted into categories of actions.
+    /// \param[in] p_changes The changes to the USDJ since the last update.
+    void skip_unchanged_bodies(UsdjBodyUpdater::Updates& p_updates,
+                               cavi::usdj_am::SceneChanges const& p_changes) const;
+
+    /// \brief Starts a worker thread for synchronizing with the server.
+    ///
+    /// \returns `Error::OK` if the worker thread is running.
+    Error start_worker();
+
+    /// \brief Ends any synchronization with the server.
+    void stop_sync();
+
+    /// \brief The count of bodies to which each kind of action was applied.
+    std::array<std::uint64_t, static_cast<std::size_t>(Action::SIZE__)> m_applied_counts;
+    /// \brief The physics bodies constructed by previous updates.
+    std::optional<UsdjBodyUpdater::Index> m_body_index;
+    bool m_body_instancing;
+    double m_body_materialization_budget;
+    UsdjBodyPool m_body_pool;
+    bool m_body_server_direct;
+    /// \brief The count of deferred calls made to apply updates to the bodies.
+    std::uint64_t m_deferred_call_count;
     String m_document_path;
     Ref<AutomergeResource> m_document_resource;
     bool m_document_scan;
-    ResultPtr m_init_result;
-    bool m_init_syncing;
+    /// \brief The renderer of the prims that don't need bodies.
+    UsdjInstancer m_instancer;
+    /// \brief The eye position by which the materializations were last
+    ///        prioritized.
+    std::optional<Vector3> m_materialization_eye;
+    /// \brief A heap of the USD prims awaiting the construction of bodies
+    ///        ordered by their distance from the eye.
+    std::vector<Materialization> m_materializations;
+    /// \brief Whether bodies were added since the scene was last fully
+    ///        materialized.
+    bool m_materializing;
+    PendingBodies m_pending_bodies;
+    /// \brief The change hashes of the version of the Automerge document that
+    ///        the bodies were last reconciled with.
+    ResultPtr m_reconciled_heads;
+    /// \brief The item at the document path when the bodies were last
+    ///        reconciled.
+    std::optional<cavi::usdj_am::utils::Item> m_reconciled_root;
+    /// \brief The objects within the tree at the document path when the
+    ///        bodies were last reconciled.
+    std::optional<cavi::usdj_am::SceneIndex> m_scene_index;
+    std::shared_ptr<AutomergeSyncHub::Channel> m_server_channel;
     String m_server_domain_name;
+    double m_server_heartbeat_interval;
     String m_server_path;
     String m_server_peer_id;
-    Ref<WebSocketPeer> m_server_socket;
+    double m_server_receive_budget;
     bool m_server_sync;
+    bool m_server_threaded;
+    /// \brief The representation of the prims within the rendering and
+    ///        physics servers.
+    UsdjServerPrims m_server_prims;
+    std::unique_ptr<AutomergeSyncWorker> m_server_worker;
+    /// \brief The count of updates to the bodies.
+    std::uint64_t m_update_count;
+    /// \brief Whether a call to apply the pending updates has been deferred.
+    bool m_updates_deferred;
 };
 
 #endif  // REALITY_MERGE_USDJ_MEDIATOR_H
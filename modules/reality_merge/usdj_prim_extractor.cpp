@@ -0,0 +1,363 @@
+/**************************************************************************/
+/* usdj_prim_extractor.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+
+// third-party
+#include <cavi/usdj_am/assignment.hpp>
+#include <cavi/usdj_am/declaration.hpp>
+#include <cavi/usdj_am/definition.hpp>
+#include <cavi/usdj_am/definition_statement.hpp>
+#include <cavi/usdj_am/definition_type.hpp>
+#include <cavi/usdj_am/descriptor.hpp>
+#include <cavi/usdj_am/external_reference.hpp>
+#include <cavi/usdj_am/reference_file.hpp>
+#include <cavi/usdj_am/usd/geom/token_type.hpp>
+#include <cavi/usdj_am/usd/geom/xform_op_type.hpp>
+#include <cavi/usdj_am/usd/sdf/value_type_name.hpp>
+#include <cavi/usdj_am/usd/token_type.hpp>
+#include <cavi/usdj_am/utils/result_arena.hpp>
+
+// regional
+#include <core/math/vector3i.h>
+
+// local
+#include "usdj_prim_extractor.h"
+#include "usdj_value.h"
+
+struct UsdjPrimExtractor::Data {
+    /// \brief Whether the prim's "size" attribute is that of a cube.
+    bool cube = false;
+    cavi::usdj_am::usd::geom::XformOpTypeOrder ops;
+    PrimProperties properties;
+    /// \brief Whether the prim's type can only come from a referenced file.
+    bool untyped = false;
+    std::map<cavi::usdj_am::usd::geom::XformOpType, UsdjValue> values;
+};
+
+std::optional<Color> UsdjPrimExtractor::PrimProperties::get_albedo() const {
+    std::optional<Color> albedo{color};
+    if (albedo && opacity)
+        albedo->a = *opacity;
+    return albedo;
+}
+
+UsdjPrimExtractor::UsdjPrimExtractor(cavi::usdj_am::Definition const& p_definition) : m_definition{p_definition} {}
+
+UsdjPrimExtractor::~UsdjPrimExtractor() {}
+
+UsdjPrimExtractor::PrimProperties UsdjPrimExtractor::operator()() {
+    if (!m_data) {
+        // The nodes within the prim are only needed until its properties have
+        // been extracted so their results are freed all at once. The
+        // "USDA_Definition" node predates the arena so it keeps its own.
+        cavi::usdj_am::utils::ResultArena arena;
+        m_data = std::make_unique<Data>();
+        m_definition.accept(*this);
+        m_data->properties.transform = compose_transform();
+    }
+    return m_data->properties;
+}
+
+std::optional<Transform3D> UsdjPrimExtractor::compose_transform() const {
+    using cavi::usdj_am::usd::geom::XformOpType;
+
+    std::optional<Transform3D> result;
+    if (m_data->ops.empty())
+        return result;
+    auto& values = m_data->values;
+    Transform3D xform{};
+    for (auto const op : m_data->ops) {
+        switch (op) {
+            case XformOpType::ORIENT: {
+                auto const& quaternion = std::get<Quaternion>(values[op]);
+                xform.basis = Basis{quaternion} * xform.basis;
+                break;
+            }
+            case XformOpType::ROTATE_X: {
+                static Vector3 const AXIS{1.0, 0.0, 0.0};
+
+                auto const& angle = std::get<real_t>(values[op]);
+                xform = xform.rotated_local(AXIS, angle);
+                break;
+            }
+            case XformOpType::ROTATE_Y: {
+                static Vector3 const AXIS{0.0, 1.0, 0.0};
+
+                auto const& angle = std::get<real_t>(values[op]);
+                xform = xform.rotated_local(AXIS, angle);
+                break;
+            }
+            case XformOpType::ROTATE_Z: {
+                static Vector3 const AXIS{0.0, 0.0, 1.0};
+
+                auto const& angle = std::get<real_t>(values[op]);
+                xform = xform.rotated_local(AXIS, angle);
+                break;
+            }
+            case XformOpType::ROTATE_XYZ: {
+                auto const& euler = std::get<Vector3>(values[op]);
+                xform.basis = Basis::from_euler(euler, EulerOrder::XYZ) * xform.basis;
+                break;
+            }
+            case XformOpType::ROTATE_XZY: {
+                auto const& euler = std::get<Vector3>(values[op]);
+                xform.basis = Basis::from_euler(euler, EulerOrder::XZY) * xform.basis;
+                break;
+            }
+            case XformOpType::ROTATE_YXZ: {
+                auto const& euler = std::get<Vector3>(values[op]);
+                xform.basis = Basis::from_euler(euler, EulerOrder::YXZ) * xform.basis;
+                break;
+            }
+            case XformOpType::ROTATE_YZX: {
+                auto const& euler = std::get<Vector3>(values[op]);
+                xform.basis = Basis::from_euler(euler, EulerOrder::YZX) * xform.basis;
+                break;
+            }
+            case XformOpType::ROTATE_ZXY: {
+                auto const& euler = std::get<Vector3>(values[op]);
+                xform.basis = Basis::from_euler(euler, EulerOrder::ZXY) * xform.basis;
+                break;
+            }
+            case XformOpType::ROTATE_ZYX: {
+                auto const& euler = std::get<Vector3>(values[op]);
+                xform.basis = Basis::from_euler(euler, EulerOrder::ZYX) * xform.basis;
+                break;
+            }
+            case XformOpType::SCALE: {
+                auto const& scale = std::get<Vector3>(values[op]);
+                xform = xform.scaled_local(scale);
+                break;
+            }
+            case XformOpType::TRANSFORM: {
+                // 4x4 matrix
+                auto const& projection = std::get<Projection>(values[op]);
+                xform = projection * Projection{xform};
+                break;
+            }
+            case XformOpType::TRANSLATE: {
+                auto const& offset = std::get<Vector3>(values[op]);
+                xform = xform.translated_local(offset);
+                break;
+            }
+            case XformOpType::RESET_XFORM_STACK: {
+                /// \note We can't do anything with this because there aren't
+                ///       any previous transformations on the stack to ignore.
+                break;
+            }
+        }
+    }
+    result.emplace(xform);
+    return result;
+}
+
+void UsdjPrimExtractor::visit(cavi::usdj_am::Assignment const& assignment) {
+    using cavi::usdj_am::AssignmentKeyword;
+    using cavi::usdj_am::ExternalReference;
+    namespace physics = cavi::usdj_am::usd::physics;
+    namespace usd = cavi::usdj_am::usd;
+
+    if (assignment.get_keyword().value_or(AssignmentKeyword{}) == AssignmentKeyword::PREPEND) {
+        if (usd::extract_TokenType(assignment.get_identifier()).value_or(usd::TokenType{}) ==
+            usd::TokenType::API_SCHEMAS) {
+            m_data->properties.api_schemas = physics::extract_TokenTypeSet(assignment.get_value());
+        } else if (m_data->untyped && assignment.get_identifier() == "references") {
+            std::visit(
+                [this](auto const& alt) {
+                    using T = std::decay_t<decltype(alt)>;
+                    if constexpr (std::is_same_v<T, ExternalReference>) {
+                        alt.accept(*this);
+                    }
+                },
+                assignment.get_value());
+        }
+    }
+}
+
+void UsdjPrimExtractor::visit(cavi::usdj_am::Declaration const& declaration) {
+    using cavi::usdj_am::DeclarationKeyword;
+    using cavi::usdj_am::usd::sdf::extract_ValueTypeName;
+    using cavi::usdj_am::usd::sdf::ValueTypeName;
+    namespace geom = cavi::usdj_am::usd::geom;
+    namespace physics = cavi::usdj_am::usd::physics;
+
+    if (declaration.get_descriptor())
+        return;
+    auto& properties = m_data->properties;
+    auto const reference = declaration.get_reference();
+    auto const keyword = declaration.get_keyword();
+    if (keyword) {
+        if (*keyword == DeclarationKeyword::UNIFORM &&
+            geom::extract_TokenType(reference).value_or(geom::TokenType{}) == geom::TokenType::XFORM_OP_ORDER &&
+            extract_ValueTypeName(declaration.get_define_type()).value_or(ValueTypeName{}) ==
+                ValueTypeName::TOKEN_ARRAY) {
+            m_data->ops = geom::extract_XformOpTypeOrder(declaration.get_value());
+        }
+        return;
+    }
+    // Dispatch on the reference so that only the values of interest are
+    // converted.
+    auto const xform_op_type = geom::extract_XformOpType(reference);
+    if (xform_op_type) {
+        if (!m_data->values.count(*xform_op_type)) {
+            auto value = extract_UsdjValue(declaration);
+            if (value)
+                m_data->values.insert(std::make_pair(*xform_op_type, std::move(*value)));
+        }
+        return;
+    }
+    auto const geom_type = geom::extract_TokenType(reference);
+    if (geom_type) {
+        switch (*geom_type) {
+            case geom::TokenType::PRIMVARS_DISPLAY_COLOR: {
+                auto const usd_value = extract_UsdjValue(declaration);
+                if (usd_value) {
+                    if (auto const color = std::get_if<Color>(&*usd_value))
+                        properties.color.emplace(*color);
+                }
+                break;
+            }
+            case geom::TokenType::PRIMVARS_DISPLAY_OPACITY: {
+                auto const usd_value = extract_UsdjValue(declaration);
+                if (usd_value) {
+                    if (auto const reals = std::get_if<Reals>(&*usd_value))
+                        properties.opacity.emplace(reals->at(0));
+                }
+                break;
+            }
+            case geom::TokenType::SIZE: {
+                if (m_data->cube && !properties.size) {
+                    auto const usd_value = extract_UsdjValue(declaration);
+                    if (usd_value) {
+                        std::visit(
+                            [&properties](auto const& alt) {
+                                using T = std::decay_t<decltype(alt)>;
+                                if constexpr (std::is_same_v<T, real_t>)
+                                    properties.size.emplace(Vector3{1.0, 1.0, 1.0} * alt);
+                                else if constexpr (std::is_same_v<T, Vector3> || std::is_same_v<T, Vector3i>)
+                                    properties.size.emplace(alt);
+                            },
+                            *usd_value);
+                    }
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+        return;
+    }
+    auto const physics_type = physics::extract_TokenType(reference);
+    if (physics_type) {
+        std::optional<Vector3>* velocity = nullptr;
+        switch (*physics_type) {
+            case physics::TokenType::PHYSICS_ANGULAR_VELOCITY: {
+                velocity = &properties.angular_velocity;
+                break;
+            }
+            case physics::TokenType::PHYSICS_VELOCITY: {
+                velocity = &properties.linear_velocity;
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+        if (velocity && !*velocity) {
+            auto const usd_value = extract_UsdjValue(declaration);
+            if (usd_value) {
+                std::visit(
+                    [velocity](auto const& alt) {
+                        using T = std::decay_t<decltype(alt)>;
+                        if constexpr (std::is_same_v<T, Vector3> || std::is_same_v<T, Vector3i>)
+                            velocity->emplace(alt);
+                    },
+                    *usd_value);
+            }
+        }
+    }
+}
+
+void UsdjPrimExtractor::visit(cavi::usdj_am::Definition const& definition) {
+    using cavi::usdj_am::DefinitionType;
+    using cavi::usdj_am::usd::geom::extract_TokenType;
+    using cavi::usdj_am::usd::geom::TokenType;
+
+    if (definition.get_sub_type() == DefinitionType::DEF) {
+        auto const def_type = definition.get_def_type();
+        m_data->cube = def_type && extract_TokenType(*def_type) == TokenType::CUBE;
+        m_data->untyped = !def_type;
+    }
+    auto const descriptor = definition.get_descriptor();
+    if (descriptor) {
+        descriptor->accept(*this);
+    }
+    for (auto const& definition_statement : definition.get_statements()) {
+        definition_statement.accept(*this);
+    }
+}
+
+void UsdjPrimExtractor::visit(cavi::usdj_am::DefinitionStatement const& definition_statement) {
+    using cavi::usdj_am::Declaration;
+
+    std::visit(
+        [this](auto const& alt) {
+            using T = std::decay_t<decltype(alt)>;
+            if constexpr (std::is_same_v<T, Declaration>)
+                alt.accept(*this);
+        },
+        definition_statement);
+}
+
+void UsdjPrimExtractor::visit(cavi::usdj_am::Descriptor const& descriptor) {
+    for (auto const& assignment : descriptor.get_assignments()) {
+        assignment.accept(*this);
+    }
+}
+
+void UsdjPrimExtractor::visit(cavi::usdj_am::ExternalReference const& external_reference) {
+    if (!external_reference.get_to_import()) {
+        auto const reference_file = external_reference.get_reference_file();
+        reference_file.accept(*this);
+    }
+}
+
+void UsdjPrimExtractor::visit(cavi::usdj_am::ReferenceFile const& reference_file) {
+    if (!reference_file.get_descriptor() && !m_data->properties.size) {
+        /// \todo Actually load the referenced file and extract the size
+        ///       attribute from within it instead of assuming unit length.
+        if (reference_file.get_src() == "cube.usda") {
+            m_data->properties.size.emplace(Vector3{1.0, 1.0, 1.0});
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/**************************************************************************/
+/* usdj_prim_extractor.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_PRIM_EXTRACTOR_H
+#define REALITY_MERGE_USDJ_PRIM_EXTRACTOR_H
+
+#include <memory>
+#include <optional>
+
+// third-party
+#include <cavi/usdj_am/usd/physics/token_type.hpp>
+#include <cavi/usdj_am/visitor.hpp>
+
+// regional
+#include <core/math/color.h>
+#include <core/math/math_defs.h>
+#include <core/math/transform_3d.h>
+#include <core/math/vector3.h>
+
+/// \brief An extractor of the property values embedded within a
+///        "USDA_Definition" node that visits each of its declarations once.
+class UsdjPrimExtractor : public cavi::usdj_am::Visitor {
+public:
+    /// \brief The property values of a USD prim, each of which is
+    ///        `std::nullopt` if the prim doesn't declare it.
+    struct PrimProperties {
+        /// \brief The API schemas applied to the prim.
+        cavi::usdj_am::usd::physics::TokenTypeSet api_schemas;
+        /// \brief The "physics:angularVelocity" attribute.
+        std::optional<Vector3> angular_velocity;
+        /// \brief The "primvars:displayColor" attribute.
+        std::optional<Color> color;
+        /// \brief The "physics:velocity" attribute.
+        std::optional<Vector3> linear_velocity;
+        /// \brief The "primvars:displayOpacity" attribute.
+        std::optional<real_t> opacity;
+        /// \brief The "size" attribute of a cube.
+        std::optional<Vector3> size;
+        /// \brief The composition of the "xformOpOrder" attribute's operations.
+        std::optional<Transform3D> transform;
+
+        /// \returns The display color combined with the display opacity or
+        ///          `std::nullopt` if there's no display color.
+        std::optional<Color> get_albedo() const;
+    };
+
+    UsdjPrimExtractor() = delete;
+
+    UsdjPrimExtractor(cavi::usdj_am::Definition const& p_definition);
+
+    UsdjPrimExtractor(UsdjPrimExtractor const&) = delete;
+
+    UsdjPrimExtractor(UsdjPrimExtractor&&) = default;
+
+    ~UsdjPrimExtractor();
+
+    UsdjPrimExtractor& operator=(UsdjPrimExtractor const&) = delete;
+
+    UsdjPrimExtractor& operator=(UsdjPrimExtractor&&) = default;
+
+    /// \returns The property values of the "USDA_Definition" node's prim.
+    PrimProperties operator()();
+
+    void visit(cavi::usdj_am::Assignment const& assignment) override;
+
+    void visit(cavi::usdj_am::Declaration const& declaration) override;
+
+    void visit(cavi::usdj_am::Definition const& definition) override;
+
+    void visit(cavi::usdj_am::DefinitionStatement const& definition_statement) override;
+
+    void visit(cavi::usdj_am::Descriptor const& descriptor) override;
+
+    void visit(cavi::usdj_am::ExternalReference const& external_reference) override;
+
+    void visit(cavi::usdj_am::ReferenceFile const& reference_file) override;
+
+private:
+    struct Data;
+
+    /// \brief Composes the transform operations gathered by the visits.
+    ///
+    /// \returns A transform or `std::nullopt` if no operations were ordered.
+    std::optional<Transform3D> compose_transform() const;
+
+    cavi::usdj_am::Definition const& m_definition;
+    std::unique_ptr<Data> m_data;
+};
+
+#endif  // REALITY_MERGE_USDJ_PRIM_EXTRACTOR_H
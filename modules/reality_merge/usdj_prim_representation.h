@@ -0,0 +1,99 @@
+/**************************************************************************/
+/* usdj_prim_representation.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_PRIM_REPRESENTATION_H
+#define REALITY_MERGE_USDJ_PRIM_REPRESENTATION_H
+
+#include <cstddef>
+#include <string>
+
+namespace cavi {
+namespace usdj_am {
+
+class Definition;
+
+}  // namespace usdj_am
+}  // namespace cavi
+
+class Node;
+
+/// \brief A representation of USD prims other than a physics body node per
+///        prim.
+class UsdjPrimRepresentation {
+public:
+    virtual ~UsdjPrimRepresentation() = default;
+
+    /// \brief Starts a pass over all of the USD prims after which the
+    ///        representations of the prims that weren't visited are removed.
+    ///
+    /// \param[in] p_parent The node relative to which the USD prims are
+    ///                     represented.
+    /// \param[in] p_stale Whether the properties of every represented prim
+    ///                    must be extracted again when it's visited.
+    virtual void begin_pass(Node* const p_parent, bool const p_stale) = 0;
+
+    /// \brief Removes all of the representations.
+    virtual void clear() = 0;
+
+    /// \param[in] p_key A USD prim's encoded object ID.
+    /// \returns `true` if the USD prim is represented.
+    virtual bool contains(std::string const& p_key) const = 0;
+
+    /// \brief Removes the representations of the USD prims that weren't
+    ///        visited during the pass.
+    virtual void end_pass() = 0;
+
+    /// \brief Marks a represented USD prim's properties to be extracted again
+    ///        when it's visited.
+    ///
+    /// \param[in] p_key A USD prim's encoded object ID.
+    virtual void invalidate(std::string const& p_key) = 0;
+
+    /// \brief Extracts a represented USD prim's properties again and updates
+    ///        its representation in place.
+    ///
+    /// \param[in] p_key A USD prim's encoded object ID.
+    /// \returns `false` if the USD prim isn't represented anymore because it
+    ///          needs a physics body node.
+    virtual bool revise(std::string const& p_key) = 0;
+
+    /// \returns The count of represented USD prims.
+    virtual std::size_t size() const = 0;
+
+    /// \brief Represents a USD prim unless it needs a physics body node.
+    ///
+    /// \param[in] p_key A USD prim's encoded object ID.
+    /// \param[in,out] p_definition A "USDA_Definition" node that's taken if
+    ///                             its USD prim is represented.
+    /// \returns `true` if the USD prim is represented.
+    /// \pre A pass has begun.
+    virtual bool visit(std::string const& p_key, cavi::usdj_am::Definition& p_definition) = 0;
+};
+
+#endif  // REALITY_MERGE_USDJ_PRIM_REPRESENTATION_H
@@ -0,0 +1,147 @@
+/**************************************************************************/
+/* usdj_resource_cache.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+// regional
+#include <core/os/memory.h>
+#include <scene/resources/box_shape_3d.h>
+#include <scene/resources/material.h>
+#include <scene/resources/primitive_meshes.h>
+
+// local
+#include "usdj_resource_cache.h"
+
+namespace {
+
+/// \brief Gets the resource cached under the given key or caches a new one.
+///
+/// \param[in,out] p_resources A map of cached resources.
+/// \param[in] p_key The key of a resource.
+/// \param[in,out] p_counts The counts of the requests to update.
+/// \param[in] p_create A function that creates a resource for \p p_key.
+template <class KeyT, class ResourceT, class CountsT, class CreateT>
+Ref<ResourceT> fetch(std::map<KeyT, Ref<ResourceT>>& p_resources,
+                     KeyT const& p_key,
+                     CountsT& p_counts,
+                     CreateT const& p_create) {
+    auto const match = p_resources.find(p_key);
+    if (match != p_resources.end()) {
+        ++p_counts.hits;
+        return match->second;
+    }
+    ++p_counts.misses;
+    return p_resources.emplace(p_key, p_create()).first->second;
+}
+
+/// \brief Releases the resources that only the given map refers to.
+///
+/// \param[in,out] p_resources A map of cached resources.
+template <class KeyT, class ResourceT>
+void release_unused(std::map<KeyT, Ref<ResourceT>>& p_resources) {
+    for (auto iter = p_resources.begin(); iter != p_resources.end();) {
+        if (iter->second->get_reference_count() == 1)
+            iter = p_resources.erase(iter);
+        else
+            ++iter;
+    }
+}
+
+}  // namespace
+
+UsdjResourceCache* UsdjResourceCache::s_singleton = nullptr;
+
+UsdjResourceCache* UsdjResourceCache::get_singleton() {
+    return s_singleton;
+}
+
+UsdjResourceCache::UsdjResourceCache() {
+    s_singleton = this;
+}
+
+UsdjResourceCache::~UsdjResourceCache() {
+    if (s_singleton == this)
+        s_singleton = nullptr;
+}
+
+void UsdjResourceCache::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("clear"), &UsdjResourceCache::clear);
+    ClassDB::bind_method(D_METHOD("get_statistics"), &UsdjResourceCache::get_statistics);
+    ClassDB::bind_method(D_METHOD("trim"), &UsdjResourceCache::trim);
+}
+
+void UsdjResourceCache::clear() {
+    m_box_meshes.clear();
+    m_box_shapes.clear();
+    m_materials.clear();
+}
+
+Ref<BoxMesh> UsdjResourceCache::get_box_mesh(Vector3 const& p_size) {
+    return fetch(m_box_meshes, p_size, m_geometry_counts, [&]() {
+        Ref<BoxMesh> box_mesh{memnew(BoxMesh)};
+        box_mesh->set_size(p_size);
+        return box_mesh;
+    });
+}
+
+Ref<BoxShape3D> UsdjResourceCache::get_box_shape(Vector3 const& p_size) {
+    return fetch(m_box_shapes, p_size, m_geometry_counts, [&]() {
+        Ref<BoxShape3D> box_shape{memnew(BoxShape3D)};
+        box_shape->set_size(p_size);
+        return box_shape;
+    });
+}
+
+Ref<BaseMaterial3D> UsdjResourceCache::get_material(Color const& p_albedo) {
+    return fetch(m_materials, p_albedo, m_material_counts, [&]() {
+        Ref<BaseMaterial3D> material{memnew(BaseMaterial3D{false})};
+        material->set_albedo(p_albedo);
+        if (p_albedo.a < 1.0)
+            material->set_transparency(BaseMaterial3D::TRANSPARENCY_ALPHA);
+        return material;
+    });
+}
+
+Dictionary UsdjResourceCache::get_statistics() const {
+    Dictionary statistics;
+    statistics["geometry_hits"] = m_geometry_counts.hits;
+    statistics["geometry_misses"] = m_geometry_counts.misses;
+    statistics["material_hits"] = m_material_counts.hits;
+    statistics["material_misses"] = m_material_counts.misses;
+    statistics["size"] = static_cast<std::uint64_t>(size());
+    return statistics;
+}
+
+std::size_t UsdjResourceCache::size() const {
+    return m_box_meshes.size() + m_box_shapes.size() + m_materials.size();
+}
+
+void UsdjResourceCache::trim() {
+    release_unused(m_box_meshes);
+    release_unused(m_box_shapes);
+    release_unused(m_materials);
+}
@@ -0,0 +1,115 @@
+/**************************************************************************/
+/* usdj_resource_cache.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_RESOURCE_CACHE_H
+#define REALITY_MERGE_USDJ_RESOURCE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+// regional
+#include <core/math/color.h>
+#include <core/math/vector3.h>
+#include <core/object/class_db.h>
+#include <core/object/object.h>
+#include <core/object/ref_counted.h>
+#include <core/variant/dictionary.h>
+
+class BaseMaterial3D;
+class BoxMesh;
+class BoxShape3D;
+
+/// \brief An engine singleton that shares the meshes, collision shapes and
+///        materials of all USDJ bodies whose USD prims have the same
+///        geometry and material parameters so that the renderer can batch
+///        them.
+///
+/// \note A shared resource must never be modified; a body whose USD prim's
+///       values change must get another resource from the cache instead.
+class UsdjResourceCache : public Object {
+    GDCLASS(UsdjResourceCache, Object);
+
+public:
+    static UsdjResourceCache* get_singleton();
+
+    UsdjResourceCache();
+
+    UsdjResourceCache(UsdjResourceCache const&) = delete;
+
+    ~UsdjResourceCache();
+
+    UsdjResourceCache& operator=(UsdjResourceCache const&) = delete;
+
+    /// \brief Releases all of the cached resources.
+    void clear();
+
+    /// \param[in] p_size The size of a box.
+    /// \returns A shared mesh of a box of the given size.
+    Ref<BoxMesh> get_box_mesh(Vector3 const& p_size);
+
+    /// \param[in] p_size The size of a box.
+    /// \returns A shared collision shape of a box of the given size.
+    Ref<BoxShape3D> get_box_shape(Vector3 const& p_size);
+
+    /// \param[in] p_albedo A color whose alpha component is its opacity.
+    /// \returns A shared material of the given color.
+    Ref<BaseMaterial3D> get_material(Color const& p_albedo);
+
+    /// \returns A dictionary of the counts of the requests for geometry and
+    ///          materials that were and weren't satisfied by the cache and of
+    ///          the cached resources.
+    Dictionary get_statistics() const;
+
+    /// \returns The count of cached resources.
+    std::size_t size() const;
+
+    /// \brief Releases the cached resources that no USDJ body refers to.
+    void trim();
+
+protected:
+    static void _bind_methods();
+
+private:
+    /// \brief The counts of the requests for a category of resources.
+    struct Counts {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+    };
+
+    std::map<Vector3, Ref<BoxMesh>> m_box_meshes;
+    std::map<Vector3, Ref<BoxShape3D>> m_box_shapes;
+    Counts m_geometry_counts;
+    Counts m_material_counts;
+    std::map<Color, Ref<BaseMaterial3D>> m_materials;
+
+    static UsdjResourceCache* s_singleton;
+};
+
+#endif  // REALITY_MERGE_USDJ_RESOURCE_CACHE_H
@@ -0,0 +1,268 @@
+/**************************************************************************/
+/* usdj_server_prims.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <utility>
+
+// regional
+#include <core/object/object.h>
+#include <scene/3d/node_3d.h>
+#include <scene/main/node.h>
+#include <scene/resources/box_shape_3d.h>
+#include <scene/resources/material.h>
+#include <scene/resources/mesh.h>
+#include <scene/resources/primitive_meshes.h>
+#include <scene/resources/world_3d.h>
+#include <servers/physics_server_3d.h>
+#include <servers/rendering_server.h>
+
+// local
+#include "usdj_geometry_extractor.h"
+#include "usdj_prim_extractor.h"
+#include "usdj_resource_cache.h"
+#include "usdj_server_prims.h"
+
+UsdjServerPrims::UsdjServerPrims() {}
+
+UsdjServerPrims::~UsdjServerPrims() {
+    clear();
+}
+
+void UsdjServerPrims::begin_pass(Node* const p_parent, bool const p_stale) {
+    Node3D* const parent = Object::cast_to<Node3D>(p_parent);
+    auto const parent_id = (parent) ? parent->get_instance_id() : ObjectID{};
+    RID scenario;
+    RID space;
+    if (parent && parent->is_inside_tree()) {
+        auto const world_3d = parent->get_world_3d();
+        if (world_3d.is_valid()) {
+            scenario = world_3d->get_scenario();
+            space = world_3d->get_space();
+        }
+    }
+    if (parent_id != m_parent_id || scenario != m_scenario || space != m_space) {
+        // The USD prims belong to another world.
+        clear();
+        m_parent_id = parent_id;
+        m_scenario = scenario;
+        m_space = space;
+    }
+    if (parent && parent->is_inside_tree())
+        m_parent_transform = parent->get_global_transform();
+    for (auto& prim : m_prims) {
+        prim.stale = prim.stale || p_stale;
+        prim.visited = false;
+    }
+}
+
+void UsdjServerPrims::clear() {
+    for (auto& prim : m_prims) {
+        free(prim);
+    }
+    m_prims.clear();
+    m_slots.clear();
+}
+
+bool UsdjServerPrims::contains(std::string const& p_key) const {
+    return m_slots.count(p_key) != 0;
+}
+
+void UsdjServerPrims::end_pass() {
+    for (std::size_t slot = 0; slot < m_prims.size();) {
+        // The USD prim has expired.
+        if (!m_prims[slot].visited)
+            remove(slot);
+        else
+            ++slot;
+    }
+}
+
+void UsdjServerPrims::follow_parent() {
+    Node3D* const parent = Object::cast_to<Node3D>(ObjectDB::get_instance(m_parent_id));
+    if (!parent || !parent->is_inside_tree())
+        return;
+    auto const parent_transform = parent->get_global_transform();
+    if (parent_transform != m_parent_transform) {
+        m_parent_transform = parent_transform;
+        for (auto const& prim : m_prims) {
+            position(prim);
+        }
+    }
+}
+
+void UsdjServerPrims::free(Prim& p_prim) {
+    if (p_prim.instance.is_valid()) {
+        RenderingServer::get_singleton()->free(p_prim.instance);
+        p_prim.instance = RID{};
+    }
+    if (p_prim.body.is_valid()) {
+        PhysicsServer3D::get_singleton()->free(p_prim.body);
+        p_prim.body = RID{};
+    }
+    p_prim.mesh.unref();
+    p_prim.material.unref();
+    p_prim.shape.unref();
+}
+
+void UsdjServerPrims::invalidate(std::string const& p_key) {
+    auto const match = m_slots.find(p_key);
+    if (match != m_slots.end())
+        m_prims[match->second].stale = true;
+}
+
+bool UsdjServerPrims::place(Prim& p_prim) {
+    namespace geom = cavi::usdj_am::usd::geom;
+
+    if (!(m_scenario.is_valid() && m_space.is_valid()))
+        return false;
+    auto const kind = UsdjGeometryExtractor{p_prim.definition}.get_kind();
+    if (!kind)
+        return false;
+    auto const resource_cache = UsdjResourceCache::get_singleton();
+    auto const properties = UsdjPrimExtractor{p_prim.definition}();
+    auto const size = properties.size.value_or(Vector3{1.0, 1.0, 1.0});
+    Ref<Mesh> mesh;
+    Ref<Shape3D> shape;
+    switch (kind->first) {
+        case geom::TokenType::CUBE: {
+            // The mesh is scaled by the instance's transform.
+            mesh = resource_cache->get_box_mesh(Vector3{1.0, 1.0, 1.0});
+            if (kind->second)
+                shape = resource_cache->get_box_shape(size);
+            break;
+        }
+            /// \todo Handle other types of gprim.
+        default: {
+            return false;
+        }
+    }
+    auto const rendering_server = RenderingServer::get_singleton();
+    bool dirty = false;
+    if (!p_prim.instance.is_valid()) {
+        p_prim.instance = rendering_server->instance_create();
+        rendering_server->instance_set_scenario(p_prim.instance, m_scenario);
+        dirty = true;
+    }
+    if (mesh != p_prim.mesh) {
+        p_prim.mesh = mesh;
+        rendering_server->instance_set_base(p_prim.instance, mesh->get_rid());
+    }
+    Ref<Material> const material = resource_cache->get_material(properties.get_albedo().value_or(Color{1, 1, 1}));
+    if (material != p_prim.material) {
+        p_prim.material = material;
+        rendering_server->instance_geometry_set_material_override(p_prim.instance, material->get_rid());
+    }
+    auto const physics_server = PhysicsServer3D::get_singleton();
+    if (shape.is_null() && p_prim.body.is_valid()) {
+        physics_server->free(p_prim.body);
+        p_prim.body = RID{};
+    } else if (shape.is_valid() && !p_prim.body.is_valid()) {
+        p_prim.body = physics_server->body_create();
+        physics_server->body_set_mode(p_prim.body, PhysicsServer3D::BODY_MODE_STATIC);
+        physics_server->body_set_space(p_prim.body, m_space);
+        dirty = true;
+    }
+    if (shape != p_prim.shape) {
+        p_prim.shape = shape;
+        if (p_prim.body.is_valid()) {
+            physics_server->body_clear_shapes(p_prim.body);
+            physics_server->body_add_shape(p_prim.body, shape->get_rid());
+        }
+    }
+    auto const transform = properties.transform.value_or(Transform3D{});
+    if (dirty || transform != p_prim.transform || size != p_prim.size) {
+        p_prim.transform = transform;
+        p_prim.size = size;
+        position(p_prim);
+    }
+    p_prim.stale = false;
+    return true;
+}
+
+void UsdjServerPrims::position(Prim const& p_prim) const {
+    auto const transform = m_parent_transform * p_prim.transform;
+    RenderingServer::get_singleton()->instance_set_transform(p_prim.instance, transform.scaled_local(p_prim.size));
+    // The shape is sized instead because physics bodies mustn't be scaled.
+    if (p_prim.body.is_valid())
+        PhysicsServer3D::get_singleton()->body_set_state(p_prim.body, PhysicsServer3D::BODY_STATE_TRANSFORM,
+                                                         transform);
+}
+
+void UsdjServerPrims::remove(std::size_t const p_slot) {
+    free(m_prims[p_slot]);
+    m_slots.erase(m_prims[p_slot].key);
+    auto const last = m_prims.size() - 1;
+    if (p_slot != last) {
+        m_prims[p_slot] = std::move(m_prims[last]);
+        m_slots[m_prims[p_slot].key] = p_slot;
+    }
+    m_prims.pop_back();
+}
+
+bool UsdjServerPrims::revise(std::string const& p_key) {
+    auto const match = m_slots.find(p_key);
+    if (match == m_slots.end())
+        return false;
+    auto const slot = match->second;
+    if (place(m_prims[slot]))
+        return true;
+    remove(slot);
+    return false;
+}
+
+std::size_t UsdjServerPrims::size() const {
+    return m_prims.size();
+}
+
+bool UsdjServerPrims::visit(std::string const& p_key, cavi::usdj_am::Definition& p_definition) {
+    auto const match = m_slots.find(p_key);
+    if (match != m_slots.end()) {
+        auto const slot = match->second;
+        auto& prim = m_prims[slot];
+        prim.visited = true;
+        if (!prim.stale)
+            return true;
+        prim.definition = std::move(p_definition);
+        if (place(prim))
+            return true;
+        // The USD prim needs a physics body node now.
+        p_definition = std::move(prim.definition);
+        remove(slot);
+        return false;
+    }
+    auto& prim = m_prims.emplace_back(
+        Prim{p_key, std::move(p_definition), RID{}, {}, {}, RID{}, {}, Transform3D{}, Vector3{}, true, true});
+    if (place(prim)) {
+        m_slots.emplace(p_key, m_prims.size() - 1);
+        return true;
+    }
+    p_definition = std::move(prim.definition);
+    free(prim);
+    m_prims.pop_back();
+    return false;
+}
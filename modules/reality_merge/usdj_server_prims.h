@@ -0,0 +1,157 @@
+/**************************************************************************/
+/* usdj_server_prims.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             RealityMerge                               */
+/*                          https://cavi.au.dk/                           */
+/**************************************************************************/
+/* Copyright (c) 2023-present RealityMerge contributors (see AUTHORS.md). */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef REALITY_MERGE_USDJ_SERVER_PRIMS_H
+#define REALITY_MERGE_USDJ_SERVER_PRIMS_H
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// third-party
+#include <cavi/usdj_am/definition.hpp>
+
+// regional
+#include <core/math/transform_3d.h>
+#include <core/math/vector3.h>
+#include <core/object/object_id.h>
+#include <core/object/ref_counted.h>
+#include <core/templates/rid.h>
+
+// local
+#include "usdj_prim_representation.h"
+
+class Material;
+class Mesh;
+class Node;
+class Shape3D;
+
+/// \brief A representation of USD prims as instances of the
+///        `RenderingServer` and bodies of the `PhysicsServer3D` without any
+///        nodes in the scene tree.
+///
+/// \note The state of the USD prims is kept in a dense array so that
+///       removing one moves the last one into its slot.
+class UsdjServerPrims : public UsdjPrimRepresentation {
+public:
+    UsdjServerPrims();
+
+    UsdjServerPrims(UsdjServerPrims const&) = delete;
+
+    UsdjServerPrims(UsdjServerPrims&&) = delete;
+
+    /// \brief Frees the servers' resources.
+    ~UsdjServerPrims() override;
+
+    UsdjServerPrims& operator=(UsdjServerPrims const&) = delete;
+
+    UsdjServerPrims& operator=(UsdjServerPrims&&) = delete;
+
+    /// \note A parent that isn't a `Node3D` inside the scene tree can't
+    ///       provide a world for the USD prims so none of them will be
+    ///       represented.
+    void begin_pass(Node* const p_parent, bool const p_stale) override;
+
+    /// \brief Removes all of the USD prims and frees the servers' resources.
+    void clear() override;
+
+    bool contains(std::string const& p_key) const override;
+
+    void end_pass() override;
+
+    /// \brief Moves the USD prims along with their parent if it has moved
+    ///        since they were last placed.
+    void follow_parent();
+
+    void invalidate(std::string const& p_key) override;
+
+    bool revise(std::string const& p_key) override;
+
+    std::size_t size() const override;
+
+    bool visit(std::string const& p_key, cavi::usdj_am::Definition& p_definition) override;
+
+private:
+    /// \brief A USD prim's server resources and the values that they reflect.
+    struct Prim {
+        /// \brief The USD prim's encoded object ID.
+        std::string key;
+        cavi::usdj_am::Definition definition;
+        /// \brief The `RenderingServer` instance.
+        RID instance;
+        Ref<Mesh> mesh;
+        Ref<Material> material;
+        /// \brief The `PhysicsServer3D` body or an invalid RID if the USD
+        ///        prim has no collision shape.
+        RID body;
+        Ref<Shape3D> shape;
+        /// \brief The USD prim's transform relative to the parent.
+        Transform3D transform;
+        Vector3 size;
+        bool stale;
+        bool visited;
+    };
+
+    static_assert(std::is_move_assignable_v<Prim>, "Removing a USD prim moves the last one into its slot.");
+
+    /// \brief Frees a USD prim's server resources.
+    ///
+    /// \param[in,out] p_prim A USD prim.
+    static void free(Prim& p_prim);
+
+    /// \brief Extracts a USD prim's properties into its server resources.
+    ///
+    /// \param[in,out] p_prim A USD prim.
+    /// \returns `false` if the USD prim can't be represented.
+    bool place(Prim& p_prim);
+
+    /// \brief Sets the transforms of a USD prim's server resources.
+    ///
+    /// \param[in] p_prim A USD prim.
+    void position(Prim const& p_prim) const;
+
+    /// \brief Removes a USD prim by moving the last one into its slot.
+    ///
+    /// \param[in] p_slot The USD prim's slot.
+    void remove(std::size_t const p_slot);
+
+    ObjectID m_parent_id;
+    /// \brief The parent's global transform when the USD prims were last
+    ///        placed.
+    Transform3D m_parent_transform;
+    std::vector<Prim> m_prims;
+    RID m_scenario;
+    /// \brief The slots of the USD prims by their encoded object IDs.
+    std::unordered_map<std::string, std::size_t> m_slots;
+    RID m_space;
+};
+
+#endif  // REALITY_MERGE_USDJ_SERVER_PRIMS_H
@@ -34,7 +34,6 @@
 // third-party
 #include <cavi/usdj_am/definition.hpp>
 #include <cavi/usdj_am/definition_type.hpp>
-#include <cavi/usdj_am/usd/physics/token_type.hpp>
 
 // regional
 #include <core/core_string_names.h>
@@ -43,15 +42,14 @@
 #include <scene/3d/collision_shape_3d.h>
 #include <scene/3d/mesh_instance_3d.h>
 #include <scene/resources/box_shape_3d.h>
+#include <scene/resources/material.h>
 #include <scene/resources/primitive_meshes.h>
 
 // local
-#include "usdj_box_size_extractor.h"
-#include "usdj_color_extractor.h"
 #include "usdj_geometry_extractor.h"
+#include "usdj_prim_extractor.h"
+#include "usdj_resource_cache.h"
 #include "usdj_static_body_3d.h"
-#include "usdj_transform_3d_extractor.h"
-#include "usdj_velocity_extractor.h"
 
 void UsdjStaticBody3D::set_physics_material_override(const Ref<PhysicsMaterial>& p_physics_material_override) {
     if (physics_material_override.is_valid()) {
@@ -98,21 +96,15 @@ void UsdjStaticBody3D::set_constant_angular_velocity(const Vector3& p_vel) {
 }
 
 Vector3 UsdjStaticBody3D::get_constant_linear_velocity() const {
-    using cavi::usdj_am::usd::physics::TokenType;
-
     static auto const DEFAULT = Vector3{};
 
-    return (m_definition) ? UsdjVelocityExtractor{*m_definition}(TokenType::PHYSICS_VELOCITY).value_or(DEFAULT)
-                          : DEFAULT;
+    return (m_definition) ? UsdjPrimExtractor{*m_definition}().linear_velocity.value_or(DEFAULT) : DEFAULT;
 }
 
 Vector3 UsdjStaticBody3D::get_constant_angular_velocity() const {
-    using cavi::usdj_am::usd::physics::TokenType;
-
     static auto const DEFAULT = Vector3{};
 
-    return (m_definition) ? UsdjVelocityExtractor{*m_definition}(TokenType::PHYSICS_ANGULAR_VELOCITY).value_or(DEFAULT)
-                          : DEFAULT;
+    return (m_definition) ? UsdjPrimExtractor{*m_definition}().angular_velocity.value_or(DEFAULT) : DEFAULT;
 }
 
 void UsdjStaticBody3D::_bind_methods() {
@@ -149,19 +141,26 @@ UsdjStaticBody3D::UsdjStaticBody3D(cavi::usdj_am::Definition&& p_definition, Phy
     if (sub_type != DefinitionType::DEF) {
         args << "p_definition.get_sub_type() == " << sub_type << ", ...";
     } else {
-        auto geometry = UsdjGeometryExtractor{*m_definition}();
+        auto geometry_extractor = UsdjGeometryExtractor{*m_definition};
+        auto geometry = geometry_extractor();
         if (geometry.first.is_null()) {
             args << "p_definition: no mesh found, ...";
         } else {
+            m_kind = geometry_extractor.get_kind();
+            // This body isn't inside the scene tree yet so it can be built
+            // immediately instead of by deferred calls.
             auto mesh_instance_3d = memnew(MeshInstance3D);
             mesh_instance_3d->set_mesh(geometry.first);
-            call_deferred(SNAME("add_child"), mesh_instance_3d);
+            /// \todo Handle multiple surfaces.
+            mesh_instance_3d->set_surface_override_material(
+                0, UsdjResourceCache::get_singleton()->get_material(Color{1, 1, 1}));
+            add_child(mesh_instance_3d);
             if (!geometry.second.is_null()) {
                 auto collision_shape_3d = memnew(CollisionShape3D);
                 collision_shape_3d->set_shape(geometry.second);
-                call_deferred(SNAME("add_child"), collision_shape_3d);
+                add_child(collision_shape_3d);
             }
-            call_deferred(SNAME("revise"));
+            revise();
         }
     }
     if (!args.str().empty()) {
@@ -183,41 +182,80 @@ void UsdjStaticBody3D::_reload_physics_characteristics() {
     }
 }
 
+std::optional<UsdjGeometryExtractor::Kind> UsdjStaticBody3D::get_kind() const {
+    return m_kind;
+}
+
 AMobjId const* UsdjStaticBody3D::get_object_id() const {
     return (m_definition) ? m_definition->get_object_id() : nullptr;
 }
 
-void UsdjStaticBody3D::revise() {
-    std::string_view const name_view = m_definition->get_name();
-    auto const name = String{name_view.data(), static_cast<int>(name_view.size())};
-    set_name(name);
-    /// \todo Replace all three of these extractors with one in order to get
-    ///       their respective values in a single pass.
-    auto const box_size = UsdjBoxSizeExtractor{*m_definition}();
-    /// \todo Handle multiple surface materials.
-    auto const color = UsdjColorExtractor{*m_definition}();
-    auto const transform_3d = UsdjTransform3dExtractor{*m_definition}();
+void UsdjStaticBody3D::recycle(cavi::usdj_am::Definition&& p_definition) {
+    m_definition.emplace(std::move(p_definition));
+    m_properties.reset();
+    // Restore the defaults of the properties that may not be revised.
+    auto const resource_cache = UsdjResourceCache::get_singleton();
     auto const node_3ds = find_children("*", "Node3D", false, false);
     for (int pos = 0; pos != node_3ds.size(); ++pos) {
         if (Node3D* const node_3d = Object::cast_to<Node3D>(node_3ds[pos])) {
-            if (transform_3d) {
-                node_3d->set_transform(*transform_3d);
-            }
+            node_3d->set_transform(Transform3D{});
             if (CollisionShape3D* const collision_shape_3d = Object::cast_to<CollisionShape3D>(node_3d)) {
-                if (box_size)
-                    if (BoxShape3D* const box_shape_3d =
-                            Object::cast_to<BoxShape3D>(collision_shape_3d->get_shape().ptr()))
-                        box_shape_3d->set_size(*box_size);
+                if (Object::cast_to<BoxShape3D>(collision_shape_3d->get_shape().ptr()))
+                    collision_shape_3d->set_shape(resource_cache->get_box_shape(Vector3{1, 1, 1}));
             }
             if (MeshInstance3D* const mesh_instance_3d = Object::cast_to<MeshInstance3D>(node_3d)) {
-                if (box_size)
-                    if (BoxMesh* const box_mesh = Object::cast_to<BoxMesh>(mesh_instance_3d->get_mesh().ptr()))
-                        box_mesh->set_size(*box_size);
-                if (color)
-                    if (BaseMaterial3D* const base_material_3d = Object::cast_to<BaseMaterial3D>(
-                            mesh_instance_3d->get_mesh()->surface_get_material(0).ptr()))
-                        base_material_3d->set_albedo(*color);
+                if (Object::cast_to<BoxMesh>(mesh_instance_3d->get_mesh().ptr()))
+                    mesh_instance_3d->set_mesh(resource_cache->get_box_mesh(Vector3{1, 1, 1}));
+                mesh_instance_3d->set_surface_override_material(0, resource_cache->get_material(Color{1, 1, 1}));
+            }
+        }
+    }
+    revise();
+}
+
+void UsdjStaticBody3D::retire() {
+    m_definition.reset();
+    m_properties.reset();
+}
+
+void UsdjStaticBody3D::revise() {
+    // A retired body no longer describes a prim.
+    if (!m_definition)
+        return;
+    std::string_view const name_view = m_definition->get_name();
+    auto const name = String{name_view.data(), static_cast<int>(name_view.size())};
+    if (get_name() != name)
+        set_name(name);
+    auto properties = UsdjPrimExtractor{*m_definition}();
+    // Only push the values that differ from the ones pushed last. The
+    // resources are shared so they're replaced instead of modified.
+    auto const& box_size = properties.size;
+    bool const box_size_dirty = box_size && (!m_properties || box_size != m_properties->size);
+    /// \todo Handle multiple surface materials.
+    auto const color = properties.get_albedo();
+    bool const color_dirty = color && (!m_properties || color != m_properties->get_albedo());
+    auto const transform_3d = properties.transform.value_or(Transform3D{});
+    bool const transform_3d_dirty = !m_properties || properties.transform != m_properties->transform;
+    if (box_size_dirty || color_dirty || transform_3d_dirty) {
+        auto const resource_cache = UsdjResourceCache::get_singleton();
+        auto const node_3ds = find_children("*", "Node3D", false, false);
+        for (int pos = 0; pos != node_3ds.size(); ++pos) {
+            if (Node3D* const node_3d = Object::cast_to<Node3D>(node_3ds[pos])) {
+                if (transform_3d_dirty) {
+                    node_3d->set_transform(transform_3d);
+                }
+                if (CollisionShape3D* const collision_shape_3d = Object::cast_to<CollisionShape3D>(node_3d)) {
+                    if (box_size_dirty && Object::cast_to<BoxShape3D>(collision_shape_3d->get_shape().ptr()))
+                        collision_shape_3d->set_shape(resource_cache->get_box_shape(*box_size));
+                }
+                if (MeshInstance3D* const mesh_instance_3d = Object::cast_to<MeshInstance3D>(node_3d)) {
+                    if (box_size_dirty && Object::cast_to<BoxMesh>(mesh_instance_3d->get_mesh().ptr()))
+                        mesh_instance_3d->set_mesh(resource_cache->get_box_mesh(*box_size));
+                    if (color_dirty)
+                        mesh_instance_3d->set_surface_override_material(0, resource_cache->get_material(*color));
+                }
             }
         }
     }
+    m_properties.emplace(std::move(properties));
 }
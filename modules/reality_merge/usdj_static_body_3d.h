@@ -40,6 +40,10 @@
 #include <scene/resources/physics_material.h>
 #include <servers/physics_server_3d.h>
 
+// local
+#include "usdj_geometry_extractor.h"
+#include "usdj_prim_extractor.h"
+
 struct AMobjId;
 
 class UsdjStaticBody3D : public PhysicsBody3D {
@@ -76,14 +80,35 @@ public:
 
     UsdjStaticBody3D& operator=(UsdjStaticBody3D&&) = default;
 
+    /// \returns The kind of geometry of this body's mesh or `std::nullopt` if
+    ///          it has none.
+    std::optional<UsdjGeometryExtractor::Kind> get_kind() const;
+
     AMobjId const* get_object_id() const;
 
+    /// \brief Represents another "USDA_Definition" with the same kind of
+    ///        geometry as this body's mesh.
+    ///
+    /// \param[in] p_definition A "USDA_Definition" node.
+    /// \pre This body isn't inside the scene tree.
+    void recycle(cavi::usdj_am::Definition&& p_definition);
+
+    /// \brief Releases this body's "USDA_Definition" node so that it can
+    ///        outlive its Automerge document.
+    void retire();
+
     /// \brief Update properties extracted from the "USDA_Definition" that had
     ///        to be cached.
+    ///
+    /// \note Only the properties whose values differ from those of the last
+    ///       revision are updated.
     void revise();
 
 private:
     std::optional<cavi::usdj_am::Definition> m_definition;
+    std::optional<UsdjGeometryExtractor::Kind> m_kind;
+    /// \brief The property values extracted by the last revision.
+    std::optional<UsdjPrimExtractor::PrimProperties> m_properties;
 
     void _reload_physics_characteristics();
 };